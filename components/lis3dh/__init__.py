@@ -1,30 +1,86 @@
-from esphome import automation
+import math
+
+from esphome import automation, pins
+import esphome.final_validate as fv
 import esphome.codegen as cg
-from esphome.components import i2c
+from esphome.components import i2c, spi
 import esphome.config_validation as cv
 from esphome.const import (
     CONF_DATA_RATE,
+    CONF_DURATION,
+    CONF_FREQUENCY,
+    CONF_I2C_ID,
     CONF_ID,
+    CONF_OFFSET,
+    CONF_PRIORITY,
     CONF_RANGE,
     CONF_RESOLUTION,
+    CONF_SPI_ID,
+    CONF_THRESHOLD,
+    CONF_TYPE,
+    PLATFORM_ESP32,
+    PLATFORM_HOST,
 )
+from esphome.core import CORE
 
 CODEOWNERS = ["@tjhorner"]
-DEPENDENCIES = ["i2c"]
 
 MULTI_CONF = True
 
+
+def AUTO_LOAD():
+    # The simulator runs the I2C component on a stand-in bus; the host has no i2c: block to load it
+    return ["i2c"] if CORE.is_host else []
+
+
+CONF_LIS3DH = "lis3dh"
 CONF_LIS3DH_ID = "lis3dh_id"
 
+CONF_INTERFACE = "interface"
+INTERFACE_I2C = "i2c"
+INTERFACE_SPI = "spi"
+INTERFACE_SIMULATOR = "simulator"
+
 CONF_ON_TAP = "on_tap"
 CONF_ON_DOUBLE_TAP = "on_double_tap"
 CONF_ON_FREEFALL = "on_freefall"
 CONF_ON_ORIENTATION = "on_orientation"
+CONF_FIFO_WATERMARK = "fifo_watermark"
+CONF_BUS_TIME_BUDGET = "bus_time_budget"
+CONF_ACQUISITION_TASK = "acquisition_task"
+CONF_CORE = "core"
+CONF_INTERRUPT1_PIN = "interrupt1_pin"
+CONF_INTERRUPT2_PIN = "interrupt2_pin"
+CONF_INACTIVITY = "inactivity"
+CONF_FILTER = "filter"
+CONF_MEDIAN = "median"
+CONF_MOVING_AVERAGE = "moving_average"
+CONF_EMA_ALPHA = "ema_alpha"
+CONF_BIQUAD = "biquad"
+CONF_CUTOFF = "cutoff"
+CONF_Q = "q"
+CONF_HIGH_PASS_FILTER = "high_pass_filter"
+CONF_OUTPUT = "output"
+CONF_CLICK = "click"
+CONF_WAVEFORM = "waveform"
+CONF_AMPLITUDE = "amplitude"
+CONF_NOISE = "noise"
+CONF_TRACE = "trace"
+CONF_BENCHMARK = "benchmark"
+CONF_REPORT_INTERVAL = "report_interval"
 
 lis3dh_ns = cg.esphome_ns.namespace("lis3dh")
-LIS3DHComponent = lis3dh_ns.class_(
-    "LIS3DHComponent", cg.PollingComponent, i2c.I2CDevice
+LIS3DHComponent = lis3dh_ns.class_("LIS3DHComponent", cg.PollingComponent)
+LIS3DHI2CComponent = lis3dh_ns.class_(
+    "LIS3DHI2CComponent", LIS3DHComponent, i2c.I2CDevice
+)
+LIS3DHSPIComponent = lis3dh_ns.class_(
+    "LIS3DHSPIComponent", LIS3DHComponent, spi.SPIDevice
 )
+LIS3DHSimComponent = lis3dh_ns.class_("LIS3DHSimComponent", LIS3DHI2CComponent)
+
+# Payload of the on_* automations, available as `event` in lambdas
+LIS3DHEvent = lis3dh_ns.struct("Event")
 
 LIS3DHRange = lis3dh_ns.enum("Range", True)
 LIS3DH_RANGES = {
@@ -43,8 +99,29 @@ LIS3DH_DATA_RATES = {
     "100HZ": LIS3DHDataRate.ODR_100HZ,
     "200HZ": LIS3DHDataRate.ODR_200HZ,
     "400HZ": LIS3DHDataRate.ODR_400HZ,
+    "1344HZ": LIS3DHDataRate.ODR_1344HZ_5376HZ_LP,
+    "1600HZ": LIS3DHDataRate.ODR_1600HZ_LP,
+    "5376HZ": LIS3DHDataRate.ODR_1344HZ_5376HZ_LP,
+}
+
+# Output data rate in Hz, used to validate filter cutoffs
+DATA_RATE_HZ = {
+    "1HZ": 1,
+    "10HZ": 10,
+    "25HZ": 25,
+    "50HZ": 50,
+    "100HZ": 100,
+    "200HZ": 200,
+    "400HZ": 400,
+    "1344HZ": 1344,
+    "1600HZ": 1600,
+    "5376HZ": 5376,
 }
 
+# Rates the chip only reaches in low-power mode, and the one it only reaches outside it
+LOW_POWER_DATA_RATES = ("1600HZ", "5376HZ")
+NOT_LOW_POWER_DATA_RATES = ("1344HZ",)
+
 LIS3DHResolution = lis3dh_ns.enum("Resolution", True)
 LIS3DH_RESOLUTIONS = {
     "LOW_POWER": LIS3DHResolution.RES_LOW_POWER,
@@ -52,35 +129,302 @@ LIS3DH_RESOLUTIONS = {
     "HIGH_RES": LIS3DHResolution.RES_HIGH_RES,
 }
 
-CONFIG_SCHEMA = (
-    cv.Schema(
-        {
-            cv.GenerateID(): cv.declare_id(LIS3DHComponent),
-            cv.Optional(CONF_RANGE, default="2G"): cv.enum(
-                LIS3DH_RANGES, upper=True
-            ),
-            cv.Optional(CONF_DATA_RATE, default="100HZ"): cv.enum(
-                LIS3DH_DATA_RATES, upper=True
-            ),
-            cv.Optional(CONF_RESOLUTION, default="HIGH_RES"): cv.enum(
-                LIS3DH_RESOLUTIONS, upper=True
-            ),
-            cv.Optional(CONF_ON_TAP): automation.validate_automation(single=True),
-            cv.Optional(CONF_ON_DOUBLE_TAP): automation.validate_automation(
-                single=True
-            ),
-            cv.Optional(CONF_ON_FREEFALL): automation.validate_automation(
-                single=True
+CONF_MAGNITUDE = "magnitude"
+
+SampleChannel = lis3dh_ns.enum("SampleChannel", True)
+SAMPLE_CHANNELS = {
+    "x": SampleChannel.X,
+    "y": SampleChannel.Y,
+    "z": SampleChannel.Z,
+    CONF_MAGNITUDE: SampleChannel.MAGNITUDE,
+}
+
+LIS3DHBiquadType = lis3dh_ns.enum("BiquadType", True)
+LIS3DH_BIQUAD_TYPES = {
+    "LOW_PASS": LIS3DHBiquadType.LOW_PASS,
+    "HIGH_PASS": LIS3DHBiquadType.HIGH_PASS,
+}
+
+
+def _validate_odd(value):
+    if value % 2 == 0:
+        raise cv.Invalid("Median window must be an odd number of samples")
+    return value
+
+
+FILTER_SCHEMA = cv.Schema(
+    {
+        cv.Optional(CONF_MEDIAN): cv.All(cv.int_range(min=3, max=15), _validate_odd),
+        cv.Optional(CONF_MOVING_AVERAGE): cv.int_range(min=2, max=32),
+        cv.Optional(CONF_EMA_ALPHA): cv.float_range(
+            min=0.0, max=1.0, min_included=False
+        ),
+        cv.Optional(CONF_BIQUAD): cv.Schema(
+            {
+                cv.Required(CONF_TYPE): cv.enum(
+                    LIS3DH_BIQUAD_TYPES, upper=True, space="_"
+                ),
+                cv.Required(CONF_CUTOFF): cv.frequency,
+                cv.Optional(CONF_Q, default=0.707): cv.positive_float,
+            }
+        ),
+    }
+)
+
+
+def _validate_data_rate(config):
+    data_rate = config[CONF_DATA_RATE]
+    low_power = config[CONF_RESOLUTION] == "LOW_POWER"
+    if data_rate in LOW_POWER_DATA_RATES and not low_power:
+        raise cv.Invalid(
+            f"A data rate of {data_rate} needs resolution LOW_POWER",
+            path=[CONF_DATA_RATE],
+        )
+    if data_rate in NOT_LOW_POWER_DATA_RATES and low_power:
+        raise cv.Invalid(
+            f"In LOW_POWER resolution this setting runs at 5376HZ; use that instead of {data_rate}",
+            path=[CONF_DATA_RATE],
+        )
+    if DATA_RATE_HZ[data_rate] > 400 and CONF_FIFO_WATERMARK not in config:
+        raise cv.Invalid(
+            f"Data rates above 400HZ need {CONF_FIFO_WATERMARK}; one read per sample can't keep up",
+            path=[CONF_DATA_RATE],
+        )
+    return config
+
+
+def _validate_filter_cutoff(config):
+    biquad = config[CONF_FILTER].get(CONF_BIQUAD)
+    if biquad is None:
+        return config
+    nyquist = DATA_RATE_HZ[config[CONF_DATA_RATE]] / 2
+    if biquad[CONF_CUTOFF] >= nyquist:
+        raise cv.Invalid(
+            f"Biquad cutoff must be below half the data rate ({nyquist} Hz)",
+            path=[CONF_FILTER, CONF_BIQUAD, CONF_CUTOFF],
+        )
+    return config
+
+
+def _validate_high_pass(config):
+    if not config[CONF_OUTPUT] and not config[CONF_CLICK]:
+        raise cv.Invalid(
+            f"Enable the filter on {CONF_OUTPUT} and/or {CONF_CLICK}, or remove it"
+        )
+    return config
+
+
+def _validate_high_pass_cutoff(config):
+    high_pass = config.get(CONF_HIGH_PASS_FILTER)
+    if high_pass is None or CONF_CUTOFF not in high_pass:
+        return config
+    data_rate = DATA_RATE_HZ[config[CONF_DATA_RATE]]
+    # The chip's range; inside it the nearest of its steps is used
+    if not data_rate / 400 <= high_pass[CONF_CUTOFF] <= data_rate / 50:
+        raise cv.Invalid(
+            f"At {data_rate} Hz the internal high-pass cutoff can be "
+            f"{data_rate / 400:g}-{data_rate / 50:g} Hz",
+            path=[CONF_HIGH_PASS_FILTER, CONF_CUTOFF],
+        )
+    return config
+
+
+def _high_pass_cutoff_index(config):
+    # The chip offers roughly ODR/50, /100, /200 and /400; pick the nearest on a log scale
+    cutoff = config[CONF_HIGH_PASS_FILTER].get(CONF_CUTOFF)
+    if cutoff is None:
+        return 0
+    data_rate = DATA_RATE_HZ[config[CONF_DATA_RATE]]
+    return min(
+        range(4),
+        key=lambda index: abs(math.log(cutoff / (data_rate / (50 << index)))),
+    )
+
+
+def _validate_inactivity(config):
+    inactivity = config.get(CONF_INACTIVITY)
+    if inactivity is None:
+        return config
+    if CONF_INTERRUPT2_PIN not in config:
+        raise cv.Invalid(
+            f"{CONF_INACTIVITY} needs {CONF_INTERRUPT2_PIN} to know when the sensor sleeps",
+            path=[CONF_INACTIVITY],
+        )
+    # ACT_DUR is 8 bits in units of 8 samples
+    max_duration = (8 * 255 + 1) / DATA_RATE_HZ[config[CONF_DATA_RATE]]
+    if inactivity[CONF_DURATION].total_milliseconds > max_duration * 1000:
+        raise cv.Invalid(
+            f"Inactivity duration can be at most {max_duration:.1f}s at this data rate",
+            path=[CONF_INACTIVITY, CONF_DURATION],
+        )
+    return config
+
+
+BASE_SCHEMA = cv.Schema(
+    {
+        cv.Optional(CONF_RANGE, default="2G"): cv.enum(LIS3DH_RANGES, upper=True),
+        cv.Optional(CONF_DATA_RATE, default="100HZ"): cv.enum(
+            LIS3DH_DATA_RATES, upper=True
+        ),
+        cv.Optional(CONF_RESOLUTION, default="HIGH_RES"): cv.enum(
+            LIS3DH_RESOLUTIONS, upper=True
+        ),
+        cv.Optional(CONF_FIFO_WATERMARK): cv.int_range(min=1, max=31),
+        # Per loop pass, shared by every instance on the same bus (the largest value wins)
+        cv.Optional(
+            CONF_BUS_TIME_BUDGET, default="2ms"
+        ): cv.positive_time_period_microseconds,
+        # Sample reads on their own task, isolated from the main loop's jitter
+        cv.Optional(CONF_ACQUISITION_TASK): cv.All(
+            cv.Schema(
+                {
+                    cv.Optional(CONF_CORE, default=1): cv.int_range(min=0, max=1),
+                    cv.Optional(CONF_PRIORITY, default=5): cv.int_range(min=1, max=24),
+                }
             ),
-            cv.Optional(CONF_ON_ORIENTATION): automation.validate_automation(
-                single=True
+            cv.only_on([PLATFORM_ESP32, PLATFORM_HOST]),
+        ),
+        cv.Optional(CONF_FILTER, default={CONF_EMA_ALPHA: 0.5}): FILTER_SCHEMA,
+        # Gravity removal in the chip. There is deliberately no option for the freefall and 6D
+        # generators: they measure gravity itself and stop working once it is filtered out.
+        cv.Optional(CONF_HIGH_PASS_FILTER): cv.All(
+            cv.Schema(
+                {
+                    # Defaults to the highest the chip offers, about ODR/50
+                    cv.Optional(CONF_CUTOFF): cv.frequency,
+                    cv.Optional(CONF_OUTPUT, default=True): cv.boolean,
+                    cv.Optional(CONF_CLICK, default=True): cv.boolean,
+                }
             ),
+            _validate_high_pass,
+        ),
+        cv.Optional(CONF_INACTIVITY): cv.Schema(
+            {
+                # m/s² of motion that counts as activity
+                cv.Optional(CONF_THRESHOLD, default=0.5): cv.positive_float,
+                cv.Optional(
+                    CONF_DURATION, default="10s"
+                ): cv.positive_time_period_milliseconds,
+            }
+        ),
+        cv.Optional(CONF_INTERRUPT1_PIN): pins.internal_gpio_input_pin_schema,
+        cv.Optional(CONF_INTERRUPT2_PIN): pins.internal_gpio_input_pin_schema,
+        cv.Optional(CONF_ON_TAP): automation.validate_automation(single=True),
+        cv.Optional(CONF_ON_DOUBLE_TAP): automation.validate_automation(single=True),
+        cv.Optional(CONF_ON_FREEFALL): automation.validate_automation(single=True),
+        cv.Optional(CONF_ON_ORIENTATION): automation.validate_automation(single=True),
+    }
+).extend(cv.polling_component_schema("10s"))
+
+
+def _validate_simulator(config):
+    # The model has no pins to raise; without them the driver polls the source registers
+    for key in (CONF_INTERRUPT1_PIN, CONF_INTERRUPT2_PIN):
+        if key in config:
+            raise cv.Invalid(
+                f"The simulator doesn't drive interrupt pins, remove {key}", path=[key]
+            )
+    return config
+
+
+def _waveform_schema(offset):
+    return cv.Schema(
+        {
+            cv.Optional(CONF_OFFSET, default=offset): cv.float_,
+            cv.Optional(CONF_AMPLITUDE, default=0.0): cv.float_,
+            cv.Optional(CONF_FREQUENCY, default="1Hz"): cv.frequency,
         }
     )
-    .extend(cv.polling_component_schema("10s"))
-    .extend(i2c.i2c_device_schema(0x18))
+
+
+# Register-level model of the chip for the host platform; values are in g
+SIMULATOR_SCHEMA = cv.Schema(
+    {
+        cv.GenerateID(): cv.declare_id(LIS3DHSimComponent),
+        cv.Exclusive(CONF_WAVEFORM, "signal"): cv.Schema(
+            {
+                cv.Optional("x", default={}): _waveform_schema(0.0),
+                cv.Optional("y", default={}): _waveform_schema(0.0),
+                cv.Optional("z", default={}): _waveform_schema(1.0),
+            }
+        ),
+        # CSV with one X,Y,Z row per sample, replayed in a loop
+        cv.Exclusive(CONF_TRACE, "signal"): cv.file_,
+        cv.Optional(CONF_NOISE, default=0.0): cv.float_range(min=0.0),
+        cv.Optional(CONF_BENCHMARK): cv.Schema(
+            {
+                cv.Optional(
+                    CONF_REPORT_INTERVAL, default="60s"
+                ): cv.positive_time_period_milliseconds,
+            }
+        ),
+    }
 )
 
+CONFIG_SCHEMA = cv.All(
+    cv.typed_schema(
+        {
+            INTERFACE_I2C: BASE_SCHEMA.extend(
+                {cv.GenerateID(): cv.declare_id(LIS3DHI2CComponent)}
+            ).extend(i2c.i2c_device_schema(0x18)),
+            INTERFACE_SPI: BASE_SCHEMA.extend(
+                {cv.GenerateID(): cv.declare_id(LIS3DHSPIComponent)}
+            ).extend(spi.spi_device_schema()),
+            INTERFACE_SIMULATOR: cv.All(
+                BASE_SCHEMA.extend(SIMULATOR_SCHEMA),
+                cv.only_on(PLATFORM_HOST),
+                _validate_simulator,
+            ),
+        },
+        key=CONF_INTERFACE,
+        default_type=INTERFACE_I2C,
+        lower=True,
+    ),
+    _validate_data_rate,
+    _validate_filter_cutoff,
+    _validate_high_pass_cutoff,
+    _validate_inactivity,
+)
+
+
+def _bus_devices(node, bus_key, bus_id):
+    """Every block anywhere in the configuration that sits on the bus with this ID."""
+    if isinstance(node, dict):
+        if bus_key in node and str(node[bus_key]) == bus_id:
+            yield node
+        for value in node.values():
+            yield from _bus_devices(value, bus_key, bus_id)
+    elif isinstance(node, list):
+        for item in node:
+            yield from _bus_devices(item, bus_key, bus_id)
+
+
+def _final_validate(config):
+    full_config = fv.full_config.get()
+    # One task serves every instance, and it takes all bus access for them
+    settings = [conf.get(CONF_ACQUISITION_TASK) for conf in full_config[CONF_LIS3DH]]
+    if any(setting != settings[0] for setting in settings):
+        raise cv.Invalid(
+            f"{CONF_ACQUISITION_TASK} must be the same on every {CONF_LIS3DH} instance"
+        )
+    # The task uses the bus outside the main loop, where nothing else on it would wait for it
+    bus_key = {INTERFACE_I2C: CONF_I2C_ID, INTERFACE_SPI: CONF_SPI_ID}.get(
+        config[CONF_INTERFACE]
+    )
+    if CONF_ACQUISITION_TASK in config and bus_key is not None:
+        lis3dh_ids = {str(conf[CONF_ID]) for conf in full_config[CONF_LIS3DH]}
+        for device in _bus_devices(full_config, bus_key, str(config[bus_key])):
+            if str(device.get(CONF_ID)) not in lis3dh_ids:
+                raise cv.Invalid(
+                    f"{CONF_ACQUISITION_TASK} needs a bus of its own, but {device.get(CONF_ID)} "
+                    f"is also on {bus_key} {config[bus_key]}",
+                    path=[CONF_ACQUISITION_TASK],
+                )
+    return config
+
+
+FINAL_VALIDATE_SCHEMA = _final_validate
+
 LIS3DH_SENSOR_SCHEMA = cv.Schema(
     {
         cv.GenerateID(CONF_LIS3DH_ID): cv.use_id(LIS3DHComponent),
@@ -88,39 +432,150 @@ LIS3DH_SENSOR_SCHEMA = cv.Schema(
 )
 
 
+def validate_pedometer_hub(config, key):
+    """The step detector needs gravity in the magnitude and at least a few samples per step."""
+    full_config = fv.full_config.get()
+    hub_path = full_config.get_path_for_id(config[CONF_LIS3DH_ID])[:-1]
+    hub_config = full_config.get_config_for_path(hub_path)
+    high_pass = hub_config.get(CONF_HIGH_PASS_FILTER)
+    if high_pass is not None and high_pass[CONF_OUTPUT]:
+        raise cv.Invalid(
+            f"{key} can't be used with the {CONF_HIGH_PASS_FILTER} on the {CONF_OUTPUT}",
+            path=[key],
+        )
+    if DATA_RATE_HZ[hub_config[CONF_DATA_RATE]] < 25:
+        raise cv.Invalid(f"{key} needs a {CONF_DATA_RATE} of 25HZ or more", path=[key])
+
+
+def _filter_capacity(key):
+    # Stage buffers are sized at compile time and shared by every instance
+    return max(conf[CONF_FILTER].get(key, 0) for conf in CORE.config[CONF_LIS3DH])
+
+
 async def to_code(config):
     var = cg.new_Pvariable(config[CONF_ID])
     await cg.register_component(var, config)
-    await i2c.register_i2c_device(var, config)
+    if config[CONF_INTERFACE] == INTERFACE_SPI:
+        await spi.register_spi_device(var, config)
+    elif config[CONF_INTERFACE] == INTERFACE_SIMULATOR:
+        cg.add_define("USE_LIS3DH_SIMULATOR")
+        if CONF_WAVEFORM in config:
+            for axis, key in enumerate(("x", "y", "z")):
+                wave = config[CONF_WAVEFORM][key]
+                cg.add(
+                    var.set_waveform(
+                        axis,
+                        wave[CONF_OFFSET],
+                        wave[CONF_AMPLITUDE],
+                        wave[CONF_FREQUENCY],
+                    )
+                )
+        if CONF_TRACE in config:
+            cg.add(var.set_trace(str(CORE.relative_config_path(config[CONF_TRACE]))))
+        cg.add(var.set_noise(config[CONF_NOISE]))
+        if CONF_BENCHMARK in config:
+            cg.add_define("USE_LIS3DH_BENCHMARK")
+            cg.add(
+                var.set_benchmark_interval(
+                    config[CONF_BENCHMARK][CONF_REPORT_INTERVAL].total_milliseconds
+                )
+            )
+    else:
+        await i2c.register_i2c_device(var, config)
 
     cg.add(var.set_range(config[CONF_RANGE]))
     cg.add(var.set_data_rate(config[CONF_DATA_RATE]))
     cg.add(var.set_resolution(config[CONF_RESOLUTION]))
+    if CONF_FIFO_WATERMARK in config:
+        cg.add(var.set_fifo_watermark(config[CONF_FIFO_WATERMARK]))
+    cg.add(var.set_bus_time_budget(config[CONF_BUS_TIME_BUDGET].total_microseconds))
+    if CONF_ACQUISITION_TASK in config:
+        task = config[CONF_ACQUISITION_TASK]
+        cg.add_define("USE_LIS3DH_ACQUISITION_TASK")
+        # The task starts once this many instances have joined their bus scheduler
+        cg.add_define("LIS3DH_INSTANCE_COUNT", len(CORE.config[CONF_LIS3DH]))
+        cg.add(var.set_acquisition_task(task[CONF_CORE], task[CONF_PRIORITY]))
+
+    filter_config = config[CONF_FILTER]
+    if CONF_MEDIAN in filter_config:
+        cg.add_define("USE_LIS3DH_MEDIAN_FILTER")
+        cg.add_define("LIS3DH_MEDIAN_FILTER_SIZE", _filter_capacity(CONF_MEDIAN))
+        cg.add(var.set_median_window(filter_config[CONF_MEDIAN]))
+    if CONF_MOVING_AVERAGE in filter_config:
+        cg.add_define("USE_LIS3DH_MOVING_AVERAGE_FILTER")
+        cg.add_define(
+            "LIS3DH_MOVING_AVERAGE_FILTER_SIZE", _filter_capacity(CONF_MOVING_AVERAGE)
+        )
+        cg.add(var.set_moving_average_window(filter_config[CONF_MOVING_AVERAGE]))
+    if CONF_EMA_ALPHA in filter_config:
+        cg.add_define("USE_LIS3DH_EMA_FILTER")
+        cg.add(var.set_ema_alpha(filter_config[CONF_EMA_ALPHA]))
+    if CONF_BIQUAD in filter_config:
+        biquad = filter_config[CONF_BIQUAD]
+        cg.add_define("USE_LIS3DH_BIQUAD_FILTER")
+        cg.add(var.set_biquad(biquad[CONF_TYPE], biquad[CONF_CUTOFF], biquad[CONF_Q]))
+
+    if CONF_HIGH_PASS_FILTER in config:
+        high_pass = config[CONF_HIGH_PASS_FILTER]
+        cg.add(
+            var.set_high_pass(
+                _high_pass_cutoff_index(config),
+                high_pass[CONF_OUTPUT],
+                high_pass[CONF_CLICK],
+            )
+        )
+
+    if CONF_INACTIVITY in config:
+        inactivity = config[CONF_INACTIVITY]
+        cg.add(
+            var.set_inactivity(
+                inactivity[CONF_THRESHOLD],
+                inactivity[CONF_DURATION].total_milliseconds,
+            )
+        )
+
+    if CONF_INTERRUPT1_PIN in config:
+        pin = await cg.gpio_pin_expression(config[CONF_INTERRUPT1_PIN])
+        cg.add(var.set_interrupt1_pin(pin))
+    if CONF_INTERRUPT2_PIN in config:
+        pin = await cg.gpio_pin_expression(config[CONF_INTERRUPT2_PIN])
+        cg.add(var.set_interrupt2_pin(pin))
+
+    # Only the detectors something listens to are configured in the chip and polled
+    if CONF_ON_TAP in config or CONF_ON_DOUBLE_TAP in config:
+        cg.add_define("USE_LIS3DH_CLICK_DETECTION")
+        cg.add(var.enable_click_detection())
+    if CONF_ON_FREEFALL in config:
+        cg.add_define("USE_LIS3DH_FREEFALL_DETECTION")
+        cg.add(var.enable_freefall_detection())
+    if CONF_ON_ORIENTATION in config:
+        cg.add_define("USE_LIS3DH_ORIENTATION_DETECTION")
+        cg.add(var.enable_orientation_detection())
 
     if CONF_ON_TAP in config:
         await automation.build_automation(
             var.get_tap_trigger(),
-            [],
+            [(LIS3DHEvent, "event")],
             config[CONF_ON_TAP],
         )
 
     if CONF_ON_DOUBLE_TAP in config:
         await automation.build_automation(
             var.get_double_tap_trigger(),
-            [],
+            [(LIS3DHEvent, "event")],
             config[CONF_ON_DOUBLE_TAP],
         )
 
     if CONF_ON_FREEFALL in config:
         await automation.build_automation(
             var.get_freefall_trigger(),
-            [],
+            [(LIS3DHEvent, "event")],
             config[CONF_ON_FREEFALL],
         )
 
     if CONF_ON_ORIENTATION in config:
         await automation.build_automation(
             var.get_orientation_trigger(),
-            [],
+            [(LIS3DHEvent, "event")],
             config[CONF_ON_ORIENTATION],
         )
@@ -0,0 +1,69 @@
+import esphome.codegen as cg
+from esphome.components import binary_sensor
+import esphome.config_validation as cv
+from esphome.const import (
+    CONF_CHANNEL,
+    CONF_FREQUENCY,
+    DEVICE_CLASS_RUNNING,
+)
+
+from . import (
+    CONF_LIS3DH_ID,
+    CONF_MAGNITUDE,
+    LIS3DH_SENSOR_SCHEMA,
+    SAMPLE_CHANNELS,
+    lis3dh_ns,
+)
+
+CODEOWNERS = ["@tjhorner"]
+DEPENDENCIES = ["lis3dh"]
+
+CONF_BLOCK_SIZE = "block_size"
+CONF_ON_THRESHOLD = "on_threshold"
+CONF_OFF_THRESHOLD = "off_threshold"
+
+GoertzelBinarySensor = lis3dh_ns.class_(
+    "GoertzelBinarySensor", binary_sensor.BinarySensor
+)
+
+
+def _validate_thresholds(config):
+    if CONF_OFF_THRESHOLD not in config:
+        config[CONF_OFF_THRESHOLD] = config[CONF_ON_THRESHOLD]
+    if config[CONF_OFF_THRESHOLD] > config[CONF_ON_THRESHOLD]:
+        raise cv.Invalid(f"{CONF_OFF_THRESHOLD} must not exceed {CONF_ON_THRESHOLD}")
+    return config
+
+
+# Thresholds are tone amplitudes in m/s²
+CONFIG_SCHEMA = cv.All(
+    binary_sensor.binary_sensor_schema(
+        GoertzelBinarySensor,
+        device_class=DEVICE_CLASS_RUNNING,
+    )
+    .extend(LIS3DH_SENSOR_SCHEMA)
+    .extend(
+        {
+            cv.Required(CONF_FREQUENCY): cv.frequency,
+            cv.Optional(CONF_CHANNEL, default=CONF_MAGNITUDE): cv.enum(
+                SAMPLE_CHANNELS, lower=True
+            ),
+            cv.Optional(CONF_BLOCK_SIZE, default=200): cv.int_range(min=16, max=2048),
+            cv.Required(CONF_ON_THRESHOLD): cv.positive_float,
+            cv.Optional(CONF_OFF_THRESHOLD): cv.positive_float,
+        }
+    ),
+    _validate_thresholds,
+)
+
+
+async def to_code(config):
+    hub = await cg.get_variable(config[CONF_LIS3DH_ID])
+    var = await binary_sensor.new_binary_sensor(config)
+    cg.add_define("USE_LIS3DH_GOERTZEL")
+    cg.add(var.set_frequency(config[CONF_FREQUENCY]))
+    cg.add(var.set_channel(config[CONF_CHANNEL]))
+    cg.add(var.set_block_size(config[CONF_BLOCK_SIZE]))
+    cg.add(var.set_on_threshold(config[CONF_ON_THRESHOLD]))
+    cg.add(var.set_off_threshold(config[CONF_OFF_THRESHOLD]))
+    cg.add(hub.add_goertzel_binary_sensor(var))
@@ -2,6 +2,11 @@
 #include "esphome/core/hal.h"
 #include "esphome/core/log.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
 namespace esphome {
 namespace lis3dh {
 
@@ -9,8 +14,8 @@ static const char *const TAG = "lis3dh";
 
 static const float GRAVITY_EARTH = 9.80665f;
 
-/// Cooldown between repeated trigger events (ms)
-static const uint32_t EVENT_COOLDOWN_MS = 500;
+/// A freefall source seen again within this many samples is the same fall, not a new one
+static const uint32_t FREEFALL_GAP_SAMPLES = 2;
 
 /// Sensitivity in g per digit (after raw >> 4) indexed by Range enum value.
 /// From the LIS3DH datasheet (high-resolution 12-bit mode):
@@ -22,6 +27,18 @@ static const uint32_t EVENT_COOLDOWN_MS = 500;
 /// because the lower bits are simply zero in those modes.
 static const float SENSITIVITY[] = {0.001f, 0.002f, 0.004f, 0.012f};
 
+/// Output data rate in Hz indexed by DataRate enum value
+static const float DATA_RATE_HZ[] = {0.0f, 1.0f, 10.0f, 25.0f, 50.0f, 100.0f, 200.0f, 400.0f, 1600.0f, 1344.0f};
+
+/// The 1.344 kHz setting runs four times faster in low-power mode
+static const float LOW_POWER_TOP_RATE_HZ = 5376.0f;
+
+/// Source register for each EventSource
+static const RegisterMap SOURCE_REGISTERS[] = {RegisterMap::CLICK_SRC, RegisterMap::INT1_SRC, RegisterMap::INT2_SRC};
+
+/// Above this rate the FIFO fills faster than a normal loop() cadence drains it
+static const float HIGH_FREQUENCY_LOOP_RATE_HZ = 400.0f;
+
 // ---- String helpers for dump_config ----
 
 static const char *range_to_string(Range range) {
@@ -57,6 +74,10 @@ static const char *data_rate_to_string(DataRate dr) {
       return "200 Hz";
     case DataRate::ODR_400HZ:
       return "400 Hz";
+    case DataRate::ODR_1600HZ_LP:
+      return "1.6 kHz";
+    case DataRate::ODR_1344HZ_5376HZ_LP:
+      return "1.344 kHz (5.376 kHz in low power)";
     default:
       return "Unknown";
   }
@@ -75,6 +96,7 @@ static const char *resolution_to_string(Resolution res) {
   }
 }
 
+#if defined(USE_TEXT_SENSOR) && defined(USE_LIS3DH_ORIENTATION_DETECTION)
 static const char *orientation_xy_to_string(OrientationXY o) {
   switch (o) {
     case OrientationXY::PORTRAIT_UPRIGHT:
@@ -91,13 +113,32 @@ static const char *orientation_xy_to_string(OrientationXY o) {
 }
 
 static const char *orientation_z_to_string(bool z) { return z ? "Downwards looking" : "Upwards looking"; }
+#endif
+
+#if defined(USE_TEXT_SENSOR) && defined(USE_LIS3DH_PEDOMETER)
+static const char *activity_to_string(Activity activity) {
+  switch (activity) {
+    case Activity::STILL:
+      return "Still";
+    case Activity::WALKING:
+      return "Walking";
+    case Activity::RUNNING:
+      return "Running";
+    default:
+      return "Unknown";
+  }
+}
+#endif
 
 // ---- Setup ----
 
 void LIS3DHComponent::setup() {
+  // Every register access goes through the bus scheduler, so join it before the first one
+  this->scheduler_ = BusScheduler::attach(this->get_bus_(), this, this->bus_time_budget_us_);
+
   // Verify chip ID
   uint8_t chip_id{0};
-  if (!this->read_byte(static_cast<uint8_t>(RegisterMap::WHO_AM_I), &chip_id) || chip_id != LIS3DH_CHIP_ID) {
+  if (!this->read_register_(RegisterMap::WHO_AM_I, &chip_id) || chip_id != LIS3DH_CHIP_ID) {
     ESP_LOGE(TAG, "WHO_AM_I register returned 0x%02X, expected 0x%02X", chip_id, LIS3DH_CHIP_ID);
     this->mark_failed();
     return;
@@ -105,27 +146,131 @@ void LIS3DHComponent::setup() {
 
   // Calculate sensitivity from range
   this->sensitivity_ = SENSITIVITY[static_cast<uint8_t>(this->range_)];
+  this->scale_ = this->sensitivity_ * GRAVITY_EARTH / (1 << SAMPLE_FRACTION_BITS);
+
+  // Read once per new sample, or once per watermark's worth of frames in FIFO mode. When nothing
+  // consumes samples (e.g. only tap automations) the output registers are never read and the FIFO
+  // stays off; the chip still samples at the configured rate for its own detectors.
+  bool sampling = this->has_sample_consumer_();
+  if (!sampling) {
+    this->fifo_watermark_ = 0;
+  }
+  uint32_t frames_per_read = this->fifo_watermark_ > 0 ? this->fifo_watermark_ : 1;
+  float odr = this->get_output_data_rate_();
+  this->acquisition_.sample_period_us = odr > 0.0f ? static_cast<uint32_t>(lroundf(1e6f / odr)) : 0;
+  this->acquisition_.read_interval_us = sampling ? this->acquisition_.sample_period_us * frames_per_read : 0;
+  if (sampling && odr > HIGH_FREQUENCY_LOOP_RATE_HZ) {
+    this->high_freq_.start();
+  }
 
-  if (!this->configure_ctrl_regs_()) {
-    ESP_LOGE(TAG, "Failed to configure control registers");
-    this->mark_failed();
-    return;
+  this->configure_filters_();
+
+#if defined(USE_SENSOR) && defined(USE_LIS3DH_DEADBAND)
+  // Thresholds in the same Q-format digits as data_, so update() never converts to decide
+  this->deadband_.axis_threshold_q = static_cast<int32_t>(lroundf(this->deadband_.axis_threshold / this->scale_));
+  int64_t vector_threshold_q = llroundf(this->deadband_.vector_threshold / this->scale_);
+  this->deadband_.vector_threshold_sq = vector_threshold_q * vector_threshold_q;
+#endif
+
+#if defined(USE_BINARY_SENSOR) && defined(USE_LIS3DH_GOERTZEL)
+  for (auto *goertzel : this->goertzel_sensors_) {
+    goertzel->setup(this->get_output_data_rate_(), this->sensitivity_ * GRAVITY_EARTH);
+  }
+#endif
+
+#if defined(USE_SENSOR) && defined(USE_LIS3DH_SPECTRUM)
+  if (this->spectrum_enabled_) {
+    this->spectrum_.setup(this->get_output_data_rate_(), this->sensitivity_ * GRAVITY_EARTH);
   }
+#endif
 
-  if (!this->configure_click_detection_()) {
-    ESP_LOGW(TAG, "Failed to configure click detection");
+#ifdef USE_LIS3DH_PEDOMETER
+  if (this->pedometer_.enabled) {
+    this->pedometer_.detector.setup(this->get_output_data_rate_(), 1.0f / this->sensitivity_);
   }
+#endif
 
-  if (!this->configure_freefall_detection_()) {
-    ESP_LOGW(TAG, "Failed to configure freefall detection");
+  // Everything but the FIFO goes out as three auto-increment bursts, read back once to make sure it stuck
+  // Detectors nobody listens to keep their all-zero (disabled) registers
+  this->configure_ctrl_regs_(this->register_image_);
+#ifdef USE_LIS3DH_CLICK_DETECTION
+  if (this->detectors_.click) {
+    this->configure_click_detection_(this->register_image_);
+  }
+#endif
+#ifdef USE_LIS3DH_FREEFALL_DETECTION
+  if (this->detectors_.freefall) {
+    this->configure_freefall_detection_(this->register_image_);
   }
+#endif
+#ifdef USE_LIS3DH_ORIENTATION_DETECTION
+  if (this->detectors_.orientation) {
+    this->configure_orientation_detection_(this->register_image_);
+  }
+#endif
+  this->configure_inactivity_(this->register_image_);
 
-  if (!this->configure_orientation_detection_()) {
-    ESP_LOGW(TAG, "Failed to configure orientation detection");
+  if (!this->write_register_image_() || !this->configure_fifo_()) {
+    ESP_LOGE(TAG, "Failed to write configuration");
+    this->mark_failed();
+    return;
+  }
+  if (!this->verify_register_image_()) {
+    ESP_LOGE(TAG, "Configuration read back does not match what was written");
+    this->mark_failed();
+    return;
   }
+
+  this->configure_interrupt_pins_();
+  // Events are placed on the sample grid from here until the first read (or forever without one)
+  this->acquisition_.last_sample_us = micros();
 }
 
-bool LIS3DHComponent::configure_ctrl_regs_() {
+bool LIS3DHComponent::has_sample_consumer_() const {
+#ifdef USE_SENSOR
+  if (this->acceleration_x_sensor_ != nullptr || this->acceleration_y_sensor_ != nullptr ||
+      this->acceleration_z_sensor_ != nullptr) {
+    return true;
+  }
+#ifdef USE_LIS3DH_MOTION_MAGNITUDE
+  if (this->motion_magnitude_sensor_ != nullptr) {
+    return true;
+  }
+#endif
+#ifdef USE_LIS3DH_INCLINOMETER
+  if (this->pitch_sensor_ != nullptr || this->roll_sensor_ != nullptr || this->tilt_sensor_ != nullptr) {
+    return true;
+  }
+#endif
+#ifdef USE_LIS3DH_STATISTICS
+  for (auto &channel_sensors : this->statistics_sensors_) {
+    for (auto *sens : channel_sensors) {
+      if (sens != nullptr) {
+        return true;
+      }
+    }
+  }
+#endif
+#ifdef USE_LIS3DH_SPECTRUM
+  if (this->spectrum_enabled_) {
+    return true;
+  }
+#endif
+#endif
+#if defined(USE_BINARY_SENSOR) && defined(USE_LIS3DH_GOERTZEL)
+  if (!this->goertzel_sensors_.empty()) {
+    return true;
+  }
+#endif
+#ifdef USE_LIS3DH_PEDOMETER
+  if (this->pedometer_.enabled) {
+    return true;
+  }
+#endif
+  return false;
+}
+
+void LIS3DHComponent::configure_ctrl_regs_(RegisterImage &image) {
   // CTRL_REG1: data rate, low-power mode, enable all axes
   RegCtrl1 ctrl1;
   ctrl1.odr = this->data_rate_;
@@ -133,31 +278,87 @@ bool LIS3DHComponent::configure_ctrl_regs_() {
   ctrl1.x_enable = true;
   ctrl1.y_enable = true;
   ctrl1.z_enable = true;
-  if (!this->write_byte(static_cast<uint8_t>(RegisterMap::CTRL_REG1), ctrl1.raw)) {
-    return false;
+  image.set(RegisterMap::CTRL_REG1, ctrl1.raw);
+
+  // CTRL_REG2: internal high-pass filter in normal mode. HP_IA1/HP_IA2 stay clear on purpose: freefall
+  // looks for the absence of gravity and 6D for its direction, and the filter would remove exactly that.
+  RegCtrl2 ctrl2;
+  ctrl2.hpcf = this->high_pass_.cutoff;
+  ctrl2.fds = this->high_pass_.output;
+  ctrl2.hpclick = this->high_pass_.click;
+  image.set(RegisterMap::CTRL_REG2, ctrl2.raw);
+
+  // CTRL_REG3: route click and freefall (IA1) to the INT1 pin when it is wired up
+  RegCtrl3 ctrl3;
+  if (this->interrupt1_pin_ != nullptr) {
+    ctrl3.i1_click = this->detectors_.click;
+    ctrl3.i1_aoi1 = this->detectors_.freefall;
   }
+  image.set(RegisterMap::CTRL_REG3, ctrl3.raw);
 
   // CTRL_REG4: full-scale range, high-resolution bit, block data update
   RegCtrl4 ctrl4;
   ctrl4.bdu = true;
   ctrl4.fs = this->range_;
   ctrl4.high_res = (this->resolution_ == Resolution::RES_HIGH_RES);
-  if (!this->write_byte(static_cast<uint8_t>(RegisterMap::CTRL_REG4), ctrl4.raw)) {
-    return false;
-  }
+  image.set(RegisterMap::CTRL_REG4, ctrl4.raw);
 
-  // CTRL_REG5: latch interrupt requests on INT1 and INT2 source registers
+  // CTRL_REG5: latch interrupt requests on INT1 and INT2 source registers, optionally enable FIFO
   RegCtrl5 ctrl5;
   ctrl5.lir_int1 = true;
   ctrl5.lir_int2 = true;
-  if (!this->write_byte(static_cast<uint8_t>(RegisterMap::CTRL_REG5), ctrl5.raw)) {
+  ctrl5.fifo_en = (this->fifo_watermark_ > 0);
+  image.set(RegisterMap::CTRL_REG5, ctrl5.raw);
+
+  // CTRL_REG6: route 6D orientation (IA2) and the sleep-to-wake state to the INT2 pin when it is wired up,
+  // active high
+  RegCtrl6 ctrl6;
+  ctrl6.i2_ia2 = (this->interrupt2_pin_ != nullptr && this->detectors_.orientation);
+  ctrl6.i2_act = (this->interrupt2_pin_ != nullptr && this->inactivity_duration_ms_ > 0);
+  image.set(RegisterMap::CTRL_REG6, ctrl6.raw);
+}
+
+bool LIS3DHComponent::configure_fifo_() {
+  // Passing through bypass mode resets the FIFO contents
+  RegFifoCtrl fifo_ctrl;
+  fifo_ctrl.fm = FifoMode::BYPASS;
+  if (!this->write_register_(RegisterMap::FIFO_CTRL, fifo_ctrl.raw)) {
     return false;
   }
 
-  return true;
+  if (this->fifo_watermark_ == 0) {
+    return true;
+  }
+
+  // Stream mode: the FIFO keeps the newest 32 frames and raises WTM once FTH frames are queued
+  fifo_ctrl.fm = FifoMode::STREAM;
+  fifo_ctrl.fth = this->fifo_watermark_;
+  return this->write_register_(RegisterMap::FIFO_CTRL, fifo_ctrl.raw);
+}
+
+void LIS3DHComponent::configure_filters_() {
+  for (auto &chain : this->filters_) {
+    (void) chain;  // unused when every stage is compiled out
+#ifdef USE_LIS3DH_MEDIAN_FILTER
+    chain.median.set_window(this->filter_config_.median_window);
+#endif
+#ifdef USE_LIS3DH_MOVING_AVERAGE_FILTER
+    chain.moving_average.set_window(this->filter_config_.moving_average_window);
+#endif
+#ifdef USE_LIS3DH_EMA_FILTER
+    chain.ema.set_alpha(this->filter_config_.ema_alpha);
+#endif
+#ifdef USE_LIS3DH_BIQUAD_FILTER
+    if (this->filter_config_.biquad_cutoff > 0.0f) {
+      chain.biquad.configure(this->filter_config_.biquad_type, this->filter_config_.biquad_cutoff,
+                             this->filter_config_.biquad_q, this->get_output_data_rate_());
+    }
+#endif
+  }
 }
 
-bool LIS3DHComponent::configure_click_detection_() {
+#ifdef USE_LIS3DH_CLICK_DETECTION
+void LIS3DHComponent::configure_click_detection_(RegisterImage &image) {
   // Enable single and double click detection on all three axes
   RegClickCfg click_cfg;
   click_cfg.x_single = true;
@@ -166,9 +367,7 @@ bool LIS3DHComponent::configure_click_detection_() {
   click_cfg.y_double = true;
   click_cfg.z_single = true;
   click_cfg.z_double = true;
-  if (!this->write_byte(static_cast<uint8_t>(RegisterMap::CLICK_CFG), click_cfg.raw)) {
-    return false;
-  }
+  image.set(RegisterMap::CLICK_CFG, click_cfg.raw);
 
   // Click threshold — aim for ~0.625g across all ranges.
   // Threshold LSB = full_scale_mg / 128.
@@ -196,29 +395,21 @@ bool LIS3DHComponent::configure_click_detection_() {
   }
   // Bit 7 = LIR_Click (latch the click interrupt until CLICK_SRC is read)
   uint8_t click_ths_reg = (click_ths & 0x7F) | 0x80;
-  if (!this->write_byte(static_cast<uint8_t>(RegisterMap::CLICK_THS), click_ths_reg)) {
-    return false;
-  }
+  image.set(RegisterMap::CLICK_THS, click_ths_reg);
 
   // TIME_LIMIT: max interval between click start and end (in 1/ODR)
-  if (!this->write_byte(static_cast<uint8_t>(RegisterMap::TIME_LIMIT), 15)) {
-    return false;
-  }
+  image.set(RegisterMap::TIME_LIMIT, 15);
 
   // TIME_LATENCY: dead zone after single click before double-click window (in 1/ODR)
-  if (!this->write_byte(static_cast<uint8_t>(RegisterMap::TIME_LATENCY), 20)) {
-    return false;
-  }
+  image.set(RegisterMap::TIME_LATENCY, 20);
 
   // TIME_WINDOW: window in which second click must arrive for double-click (in 1/ODR)
-  if (!this->write_byte(static_cast<uint8_t>(RegisterMap::TIME_WINDOW), 50)) {
-    return false;
-  }
-
-  return true;
+  image.set(RegisterMap::TIME_WINDOW, 50);
 }
+#endif
 
-bool LIS3DHComponent::configure_freefall_detection_() {
+#ifdef USE_LIS3DH_FREEFALL_DETECTION
+void LIS3DHComponent::configure_freefall_detection_(RegisterImage &image) {
   // INT1 generator: freefall = AND combination, all axes below threshold
   RegIntCfg int1_cfg;
   int1_cfg.aoi = true;
@@ -226,9 +417,7 @@ bool LIS3DHComponent::configure_freefall_detection_() {
   int1_cfg.x_low = true;
   int1_cfg.y_low = true;
   int1_cfg.z_low = true;
-  if (!this->write_byte(static_cast<uint8_t>(RegisterMap::INT1_CFG), int1_cfg.raw)) {
-    return false;
-  }
+  image.set(RegisterMap::INT1_CFG, int1_cfg.raw);
 
   // Freefall threshold — aim for ~350 mg.
   // Threshold LSB = full_scale_mg / 128.
@@ -250,19 +439,15 @@ bool LIS3DHComponent::configure_freefall_detection_() {
       ff_ths = 22;
       break;
   }
-  if (!this->write_byte(static_cast<uint8_t>(RegisterMap::INT1_THS), ff_ths & 0x7F)) {
-    return false;
-  }
+  image.set(RegisterMap::INT1_THS, ff_ths & 0x7F);
 
   // Duration: minimum time the condition must hold (in 1/ODR)
-  if (!this->write_byte(static_cast<uint8_t>(RegisterMap::INT1_DUR), 3)) {
-    return false;
-  }
-
-  return true;
+  image.set(RegisterMap::INT1_DUR, 3);
 }
+#endif
 
-bool LIS3DHComponent::configure_orientation_detection_() {
+#ifdef USE_LIS3DH_ORIENTATION_DETECTION
+void LIS3DHComponent::configure_orientation_detection_(RegisterImage &image) {
   // INT2 generator: 6D movement detection (OR combination with 6D flag)
   RegIntCfg int2_cfg;
   int2_cfg.aoi = false;
@@ -273,9 +458,7 @@ bool LIS3DHComponent::configure_orientation_detection_() {
   int2_cfg.y_high = true;
   int2_cfg.z_low = true;
   int2_cfg.z_high = true;
-  if (!this->write_byte(static_cast<uint8_t>(RegisterMap::INT2_CFG), int2_cfg.raw)) {
-    return false;
-  }
+  image.set(RegisterMap::INT2_CFG, int2_cfg.raw);
 
   // Orientation threshold — aim for ~400 mg
   uint8_t orient_ths;
@@ -296,22 +479,118 @@ bool LIS3DHComponent::configure_orientation_detection_() {
       orient_ths = 26;
       break;
   }
-  if (!this->write_byte(static_cast<uint8_t>(RegisterMap::INT2_THS), orient_ths & 0x7F)) {
-    return false;
+  image.set(RegisterMap::INT2_THS, orient_ths & 0x7F);
+
+  image.set(RegisterMap::INT2_DUR, 0);
+}
+#endif
+
+void LIS3DHComponent::configure_inactivity_(RegisterImage &image) {
+  if (this->inactivity_duration_ms_ == 0) {
+    return;
   }
 
-  if (!this->write_byte(static_cast<uint8_t>(RegisterMap::INT2_DUR), 0)) {
+  // ACT_THS LSB depends on full scale: 16 / 32 / 62 / 186 mg
+  static const float ACT_THS_MG[] = {16.0f, 32.0f, 62.0f, 186.0f};
+  float threshold_mg = this->inactivity_threshold_ / GRAVITY_EARTH * 1000.0f;
+  long act_ths = lroundf(threshold_mg / ACT_THS_MG[static_cast<uint8_t>(this->range_)]);
+  act_ths = std::max(1L, std::min(act_ths, 127L));
+  image.set(RegisterMap::ACT_THS, static_cast<uint8_t>(act_ths));
+
+  // ACT_DUR counts in (8 · LSB + 1) / ODR
+  float odr = this->get_output_data_rate_();
+  long act_dur = lroundf((this->inactivity_duration_ms_ / 1000.0f * odr - 1.0f) / 8.0f);
+  act_dur = std::max(0L, std::min(act_dur, 255L));
+  image.set(RegisterMap::ACT_DUR, static_cast<uint8_t>(act_dur));
+}
+
+bool LIS3DHComponent::write_register_image_() {
+  // The source registers inside the blocks are read-only; the chip ignores writes to them
+  const RegisterImage &image = this->register_image_;
+  return this->write_registers_(RegisterMap::CTRL_REG1, image.ctrl, sizeof(image.ctrl)) &&
+         this->write_registers_(RegisterMap::INT1_CFG, image.interrupt, sizeof(image.interrupt)) &&
+         this->write_registers_(RegisterMap::CLICK_CFG, image.click, sizeof(image.click));
+}
+
+bool LIS3DHComponent::verify_register_image_() {
+  RegisterImage actual;
+  if (!this->read_registers_(RegisterMap::CTRL_REG1, actual.ctrl, sizeof(actual.ctrl)) ||
+      !this->read_registers_(RegisterMap::INT1_CFG, actual.interrupt, sizeof(actual.interrupt)) ||
+      !this->read_registers_(RegisterMap::CLICK_CFG, actual.click, sizeof(actual.click))) {
     return false;
   }
+  // Reading the blocks back also cleared the latched sources, which is what setup wants anyway
+  for (auto reg : {RegisterMap::INT1_SRC, RegisterMap::INT2_SRC, RegisterMap::CLICK_SRC}) {
+    actual.set(reg, this->register_image_.get(reg));
+  }
+  return memcmp(&actual, &this->register_image_, sizeof(RegisterImage)) == 0;
+}
 
-  return true;
+ImageCheck LIS3DHComponent::repair_register_image_(uint8_t *found_ctrl1) {
+  // A brown-out or glitch resets the chip to its power-on defaults without telling anyone.
+  // One burst read of CTRL_REG1..6 is enough to notice: CTRL_REG5 always has the latch bits set.
+  uint8_t ctrl[sizeof(RegisterImage::ctrl)];
+  if (!this->read_registers_(RegisterMap::CTRL_REG1, ctrl, sizeof(ctrl))) {
+    return ImageCheck::READ_FAILED;
+  }
+  *found_ctrl1 = ctrl[0];
+  if (memcmp(ctrl, this->register_image_.ctrl, sizeof(ctrl)) == 0) {
+    return ImageCheck::INTACT;
+  }
+  if (!this->write_register_image_() || !this->configure_fifo_() || !this->verify_register_image_()) {
+    return ImageCheck::REAPPLY_FAILED;
+  }
+  // Whatever was pending in the FIFO and the source registers died with the old configuration
+  this->status_.sleeping = false;
+  this->read_now_ = true;
+  return ImageCheck::REAPPLIED;
+}
+
+void LIS3DHComponent::report_register_image_(ImageCheck check, uint8_t found_ctrl1) {
+  if (check != ImageCheck::REAPPLIED && check != ImageCheck::REAPPLY_FAILED) {
+    return;
+  }
+  ESP_LOGW(TAG, "Sensor configuration was lost (CTRL_REG1 0x%02X, expected 0x%02X), reapplying", found_ctrl1,
+           this->register_image_.ctrl[0]);
+  this->status_.chip_resets++;
+  if (check == ImageCheck::REAPPLY_FAILED) {
+    ESP_LOGW(TAG, "Reapplying configuration failed, retrying on the next update");
+  }
 }
 
+void LIS3DHComponent::check_register_image_() {
+#ifdef USE_LIS3DH_ACQUISITION_TASK
+  // The task does the bus work and loop() reports it, like the event sources
+  this->image_check_.requested.store(true, std::memory_order_release);
+#else
+  uint8_t found_ctrl1 = 0;
+  ImageCheck check = this->repair_register_image_(&found_ctrl1);
+  this->report_register_image_(check, found_ctrl1);
+#endif
+}
+
+void LIS3DHComponent::configure_interrupt_pins_() {
+  // Stores start out triggered so the first loop() clears anything latched before the ISR was attached
+  if (this->interrupt1_pin_ != nullptr) {
+    this->interrupt1_pin_->setup();
+    this->interrupt1_pin_->attach_interrupt(InterruptPinStore::gpio_intr, &this->interrupt1_store_,
+                                            gpio::INTERRUPT_RISING_EDGE);
+  }
+  if (this->interrupt2_pin_ != nullptr) {
+    // With sleep-to-wake the falling edge matters too: that's the chip waking up
+    this->interrupt2_pin_->setup();
+    this->interrupt2_pin_->attach_interrupt(
+        InterruptPinStore::gpio_intr, &this->interrupt2_store_,
+        this->inactivity_duration_ms_ > 0 ? gpio::INTERRUPT_ANY_EDGE : gpio::INTERRUPT_RISING_EDGE);
+  }
+}
+
+void IRAM_ATTR InterruptPinStore::gpio_intr(InterruptPinStore *arg) { arg->triggered = true; }
+
 // ---- dump_config ----
 
 void LIS3DHComponent::dump_config() {
   ESP_LOGCONFIG(TAG, "LIS3DH:");
-  LOG_I2C_DEVICE(this);
   if (this->is_failed()) {
     ESP_LOGE(TAG, ESP_LOG_MSG_COMM_FAIL);
   }
@@ -321,109 +600,427 @@ void LIS3DHComponent::dump_config() {
                 "  Resolution: %s",
                 range_to_string(this->range_), data_rate_to_string(this->data_rate_),
                 resolution_to_string(this->resolution_));
+  if (this->fifo_watermark_ > 0) {
+    ESP_LOGCONFIG(TAG, "  FIFO: stream mode, watermark %u frames", this->fifo_watermark_);
+  } else {
+    ESP_LOGCONFIG(TAG, "  FIFO: disabled");
+  }
+#ifdef USE_LIS3DH_MEDIAN_FILTER
+  ESP_LOGCONFIG(TAG, "  Median Filter: %u samples", this->filter_config_.median_window);
+#endif
+#ifdef USE_LIS3DH_MOVING_AVERAGE_FILTER
+  ESP_LOGCONFIG(TAG, "  Moving Average Filter: %u samples", this->filter_config_.moving_average_window);
+#endif
+#ifdef USE_LIS3DH_EMA_FILTER
+  ESP_LOGCONFIG(TAG, "  EMA Filter: alpha %.3f", this->filter_config_.ema_alpha);
+#endif
+#ifdef USE_LIS3DH_BIQUAD_FILTER
+  if (this->filter_config_.biquad_cutoff > 0.0f) {
+    ESP_LOGCONFIG(TAG, "  Biquad Filter: %s, cutoff %.2f Hz, Q %.3f",
+                  this->filter_config_.biquad_type == BiquadType::LOW_PASS ? "low-pass" : "high-pass",
+                  this->filter_config_.biquad_cutoff, this->filter_config_.biquad_q);
+  }
+#endif
+  if (this->high_pass_.output || this->high_pass_.click) {
+    ESP_LOGCONFIG(TAG, "  Internal High-Pass: cutoff ~%.2f Hz on%s%s",
+                  this->get_output_data_rate_() / (50 << this->high_pass_.cutoff),
+                  this->high_pass_.output ? " output" : "", this->high_pass_.click ? " click" : "");
+  }
+  ESP_LOGCONFIG(TAG, "  Detectors:%s%s%s", this->detectors_.click ? " click" : "",
+                this->detectors_.freefall ? " freefall" : "", this->detectors_.orientation ? " 6D" : "");
+  if (this->acquisition_.read_interval_us > 0) {
+    ESP_LOGCONFIG(TAG, "  Read Interval: %.1f ms", this->acquisition_.read_interval_us / 1000.0f);
+  } else {
+    ESP_LOGCONFIG(TAG, "  Read Interval: never (no sample consumers)");
+  }
+  ESP_LOGCONFIG(TAG, "  Overruns: %" PRIu32 " data, %" PRIu32 " FIFO", this->status_.data_overruns.load(),
+                this->status_.fifo_overruns.load());
+  ESP_LOGCONFIG(TAG, "  Chip Resets: %" PRIu32, this->status_.chip_resets);
+  ESP_LOGCONFIG(TAG, "  Samples: %" PRIu32 " read, %" PRIu32 " lost", this->acquisition_.samples_read,
+                this->get_samples_lost_());
+  ESP_LOGCONFIG(TAG, "  Bus Errors: %" PRIu32, this->status_.bus_errors.load());
+  ESP_LOGCONFIG(TAG, "  Events Dropped: %" PRIu32, this->events_.get_overflows());
+  if (this->scheduler_ != nullptr) {
+    ESP_LOGCONFIG(TAG, "  Bus: shared by %u instance(s), %" PRIu32 " µs per loop%s", (unsigned) this->scheduler_->size(),
+                  this->scheduler_->get_time_budget(), this->scheduler_->is_owner(this) ? " (scheduler)" : "");
+  }
+  if (this->inactivity_duration_ms_ > 0) {
+    ESP_LOGCONFIG(TAG, "  Inactivity: below %.2f m/s² for %.1f s", this->inactivity_threshold_,
+                  this->inactivity_duration_ms_ / 1000.0f);
+  }
+  LOG_PIN("  INT1 Pin: ", this->interrupt1_pin_);
+  LOG_PIN("  INT2 Pin: ", this->interrupt2_pin_);
   LOG_UPDATE_INTERVAL(this);
 
 #ifdef USE_SENSOR
+#ifdef USE_LIS3DH_DEADBAND
+  if (this->deadband_.enabled) {
+    ESP_LOGCONFIG(TAG,
+                  "  Deadband: axis %.3f m/s², vector %.3f m/s², max silence %" PRIu32 " ms, %" PRIu32
+                  " publishes suppressed",
+                  this->deadband_.axis_threshold, this->deadband_.vector_threshold, this->deadband_.max_silence_ms,
+                  this->deadband_.suppressed);
+  }
+#endif
   LOG_SENSOR("  ", "Acceleration X", this->acceleration_x_sensor_);
   LOG_SENSOR("  ", "Acceleration Y", this->acceleration_y_sensor_);
   LOG_SENSOR("  ", "Acceleration Z", this->acceleration_z_sensor_);
+#ifdef USE_LIS3DH_MOTION_MAGNITUDE
+  LOG_SENSOR("  ", "Motion Magnitude", this->motion_magnitude_sensor_);
+#endif
+#ifdef USE_LIS3DH_INCLINOMETER
+  LOG_SENSOR("  ", "Pitch", this->pitch_sensor_);
+  LOG_SENSOR("  ", "Roll", this->roll_sensor_);
+  LOG_SENSOR("  ", "Tilt", this->tilt_sensor_);
+#endif
+  LOG_SENSOR("  ", "Bus Utilization (LIS3DH share)", this->bus_utilization_sensor_);
+  LOG_SENSOR("  ", "Samples Read", this->samples_read_sensor_);
+  LOG_SENSOR("  ", "Samples Lost", this->samples_lost_sensor_);
+  LOG_SENSOR("  ", "Bus Errors", this->bus_errors_sensor_);
+  LOG_SENSOR("  ", "Events Dropped", this->events_dropped_sensor_);
+#ifdef USE_LIS3DH_SPECTRUM
+  if (this->spectrum_enabled_) {
+    this->spectrum_.dump_config();
+  }
+#endif
+#endif
+
+#if defined(USE_BINARY_SENSOR) && defined(USE_LIS3DH_GOERTZEL)
+  for (auto *goertzel : this->goertzel_sensors_) {
+    goertzel->dump_config();
+  }
 #endif
 
 #ifdef USE_TEXT_SENSOR
   LOG_TEXT_SENSOR("  ", "Orientation XY", this->orientation_xy_text_sensor_);
   LOG_TEXT_SENSOR("  ", "Orientation Z", this->orientation_z_text_sensor_);
 #endif
+
+#ifdef USE_LIS3DH_PEDOMETER
+  if (this->pedometer_.enabled) {
+    ESP_LOGCONFIG(TAG, "  Pedometer: %" PRIu32 " steps", this->pedometer_.detector.get_steps());
+#ifdef USE_SENSOR
+    LOG_SENSOR("    ", "Step Count", this->step_count_sensor_);
+#endif
+#ifdef USE_TEXT_SENSOR
+    LOG_TEXT_SENSOR("    ", "Activity", this->activity_text_sensor_);
+#endif
+  }
+#endif
 }
 
 // ---- Data reading ----
 
 bool LIS3DHComponent::read_data_() {
-  uint8_t accel_data[6];
+  if (this->fifo_watermark_ > 0) {
+    return this->read_fifo_();
+  }
+
+  // STATUS_REG sits directly in front of OUT_X_L, so status and the frame come back in one burst
+  uint8_t accel_data[1 + FRAME_SIZE];
+  if (!this->read_registers_(RegisterMap::STATUS_REG, accel_data, sizeof(accel_data))) {
+    return false;
+  }
+
+  RegStatus status;
+  status.raw = accel_data[0];
+  if (!status.zyxda) {
+    // Same sample as last time; feeding it to the filter again would skew it
+    return true;
+  }
+  if (status.zyxor) {
+    // A sample was overwritten before we got to it
+    this->status_.data_overruns++;
+  }
+
+  this->block_.decode(&accel_data[1], 1);
+  this->handle_block_();
+
+  return true;
+}
 
-  // Multi-byte I2C read requires the auto-increment bit (0x80) set on the sub-address
-  if (!this->read_bytes(static_cast<uint8_t>(RegisterMap::OUT_X_L) | I2C_AUTO_INCREMENT, accel_data, 6)) {
+bool LIS3DHComponent::read_fifo_() {
+  RegFifoSrc fifo_src;
+  if (!this->read_register_(RegisterMap::FIFO_SRC, &fifo_src.raw)) {
     return false;
   }
 
-  // Raw data is left-justified in 16 bits. Shift right by 4 to obtain the
-  // 12-bit-equivalent value (lower bits are zero in 10-bit and 8-bit modes).
-  int16_t raw_x = static_cast<int16_t>((accel_data[1] << 8) | accel_data[0]) >> 4;
-  int16_t raw_y = static_cast<int16_t>((accel_data[3] << 8) | accel_data[2]) >> 4;
-  int16_t raw_z = static_cast<int16_t>((accel_data[5] << 8) | accel_data[4]) >> 4;
+  // Nothing to do until the watermark is reached; an overrun means the FIFO is full, so drain it too
+  if (!fifo_src.wtm && !fifo_src.ovrn) {
+    return true;
+  }
+
+  // FSS saturates at 31; with the overrun flag set all 32 slots hold unread frames
+  uint8_t frames = fifo_src.ovrn ? FIFO_DEPTH : fifo_src.fss;
+  if (fifo_src.ovrn) {
+    this->status_.fifo_overruns++;
+    ESP_LOGV(TAG, "FIFO overrun, oldest frames were overwritten");
+  }
+  if (frames == 0) {
+    return true;
+  }
 
-  // Convert to m/s² with simple single-pole low-pass filter (α = 0.5)
-  auto lpf = [](float new_val, float old_val) -> float { return 0.5f * new_val + 0.5f * old_val; };
+  // In FIFO mode the auto-incremented address wraps from OUT_Z_H back to OUT_X_L,
+  // so every queued frame can be drained in a single burst.
+  uint8_t fifo_data[FIFO_DEPTH * FRAME_SIZE];
+  if (!this->read_registers_(RegisterMap::OUT_X_L, fifo_data, frames * FRAME_SIZE)) {
+    return false;
+  }
 
-  this->data_.x = lpf(raw_x * this->sensitivity_ * GRAVITY_EARTH, this->data_.x);
-  this->data_.y = lpf(raw_y * this->sensitivity_ * GRAVITY_EARTH, this->data_.y);
-  this->data_.z = lpf(raw_z * this->sensitivity_ * GRAVITY_EARTH, this->data_.z);
+  this->block_.decode(fifo_data, frames);
+  this->handle_block_();
 
   return true;
 }
 
-// ---- Event polling ----
+void LIS3DHComponent::handle_block_() {
+  this->acquisition_.frames_read += this->block_.size;
+#ifdef USE_LIS3DH_ACQUISITION_TASK
+  // Called on the acquisition task; everything downstream runs in loop()
+  for (size_t i = 0; i < this->block_.size; i++) {
+    this->frames_.push(RawFrame{this->block_.x[i], this->block_.y[i], this->block_.z[i]});
+  }
+#else
+  this->process_block_(this->block_);
+#endif
+}
 
-void LIS3DHComponent::poll_click_source_() {
-  RegClickSrc click_src;
-  // Reading CLICK_SRC clears the latched interrupt
-  if (!this->read_byte(static_cast<uint8_t>(RegisterMap::CLICK_SRC), &click_src.raw)) {
+void LIS3DHComponent::process_block_(SampleBlock<FIFO_DEPTH> &block) {
+  if (block.size == 0) {
     return;
   }
+  this->acquisition_.samples_read += block.size;
+
+  // Filter chain runs in Q-format integer math. Conversion to m/s² is deferred to
+  // update(), so boards without an FPU don't pay for soft-float per sample.
+  this->data_.x = this->filters_[0].apply_block(block.x, block.size, SAMPLE_FRACTION_BITS);
+  this->data_.y = this->filters_[1].apply_block(block.y, block.size, SAMPLE_FRACTION_BITS);
+  this->data_.z = this->filters_[2].apply_block(block.z, block.size, SAMPLE_FRACTION_BITS);
+
+#if defined(USE_SENSOR) && defined(USE_LIS3DH_STATISTICS)
+  // Statistics see the raw samples so short shocks aren't smoothed away by the filter chain
+  for (uint8_t channel = 0; channel < SAMPLE_CHANNEL_COUNT; channel++) {
+    this->statistics_[channel].add_block(block.channel(static_cast<SampleChannel>(channel)), block.size);
+  }
+#endif
+
+#if defined(USE_SENSOR) && defined(USE_LIS3DH_INCLINOMETER)
+  if (this->pitch_sensor_ != nullptr || this->roll_sensor_ != nullptr || this->tilt_sensor_ != nullptr)
+    this->update_inclination_();
+#endif
+
+#if defined(USE_SENSOR) && defined(USE_LIS3DH_MOTION_MAGNITUDE)
+  // With the output high-passed the raw samples carry no gravity, so their norm is the motion itself
+  if (this->motion_magnitude_sensor_ != nullptr)
+    this->motion_.add_block(block.channel(SampleChannel::MAGNITUDE), block.size);
+#endif
+
+#if defined(USE_BINARY_SENSOR) && defined(USE_LIS3DH_GOERTZEL)
+  for (auto *goertzel : this->goertzel_sensors_) {
+    goertzel->add_samples(block.channel(goertzel->get_channel()), block.size);
+  }
+#endif
+
+#if defined(USE_SENSOR) && defined(USE_LIS3DH_SPECTRUM)
+  if (this->spectrum_enabled_) {
+    this->spectrum_.add_samples(block.channel(this->spectrum_channel_), block.size);
+  }
+#endif
+
+#ifdef USE_LIS3DH_PEDOMETER
+  if (this->pedometer_.enabled) {
+    this->pedometer_.detector.add_samples(block.channel(SampleChannel::MAGNITUDE), block.size);
+  }
+#endif
+}
+
+// ---- Event polling ----
 
+Event LIS3DHComponent::make_event_(EventType type, EventAxis axis, bool negative, uint32_t read_us) {
+  // A source latches on the newest sample the chip had produced when it was read: the last one we
+  // read plus however many whole sample periods had passed since. Timestamp that sample, not the poll.
+  // With the acquisition task a newer sample may have been read since the source was; clamp to it.
+  uint32_t last_sample_us = this->acquisition_.last_sample_us;
+  auto since_sample_us = static_cast<int32_t>(read_us - last_sample_us);
+  uint32_t period_us = this->acquisition_.sample_period_us;
+  uint32_t pending = period_us > 0 && since_sample_us > 0 ? since_sample_us / period_us : 0;
+  uint32_t sample_us = last_sample_us + pending * period_us;
+
+  Event event;
+  event.type = type;
+  event.axis = axis;
+  event.negative = negative;
+  event.sample_index = this->acquisition_.samples_read + pending;
+  event.timestamp_ms = millis() - (micros() - sample_us) / 1000;
+  return event;
+}
+
+#ifdef USE_LIS3DH_CLICK_DETECTION
+void LIS3DHComponent::handle_click_source_(uint8_t raw, uint32_t read_us) {
+  RegClickSrc click_src;
+  click_src.raw = raw;
   if (!click_src.ia) {
     return;
   }
 
-  uint32_t now = millis();
-
-  if (click_src.single_click && (now - this->status_.last_tap_ms > EVENT_COOLDOWN_MS)) {
+  // Every latched click is its own event; the click engine's latency/window already debounce
+  EventAxis axis = EventAxis::NONE;
+  if (click_src.x) {
+    axis = EventAxis::X;
+  } else if (click_src.y) {
+    axis = EventAxis::Y;
+  } else if (click_src.z) {
+    axis = EventAxis::Z;
+  }
+  if (click_src.single_click) {
     ESP_LOGV(TAG, "Single tap detected");
-    this->tap_trigger_.trigger();
-    this->status_.last_tap_ms = now;
+    this->events_.push(this->make_event_(EventType::TAP, axis, click_src.sign, read_us));
   }
-
-  if (click_src.double_click && (now - this->status_.last_double_tap_ms > EVENT_COOLDOWN_MS)) {
+  if (click_src.double_click) {
     ESP_LOGV(TAG, "Double tap detected");
-    this->double_tap_trigger_.trigger();
-    this->status_.last_double_tap_ms = now;
+    this->events_.push(this->make_event_(EventType::DOUBLE_TAP, axis, click_src.sign, read_us));
   }
 }
+#endif
 
-void LIS3DHComponent::poll_int1_source_() {
+#ifdef USE_LIS3DH_FREEFALL_DETECTION
+void LIS3DHComponent::handle_int1_source_(uint8_t raw, uint32_t read_us) {
   RegIntSrc int1_src;
-  // Reading INT1_SRC clears the latched interrupt
-  if (!this->read_byte(static_cast<uint8_t>(RegisterMap::INT1_SRC), &int1_src.raw)) {
-    return;
-  }
-
+  int1_src.raw = raw;
   if (!int1_src.ia) {
     return;
   }
 
-  uint32_t now = millis();
-  if (now - this->status_.last_freefall_ms > EVENT_COOLDOWN_MS) {
+  // The freefall source re-latches on every sample while the fall lasts; only its start is an event
+  Event event = this->make_event_(EventType::FREEFALL, EventAxis::NONE, false, read_us);
+  bool continuing = this->status_.freefall_seen &&
+                    event.sample_index - this->status_.last_freefall_sample <= FREEFALL_GAP_SAMPLES;
+  this->status_.freefall_seen = true;
+  this->status_.last_freefall_sample = event.sample_index;
+  if (!continuing) {
     ESP_LOGV(TAG, "Freefall detected");
-    this->freefall_trigger_.trigger();
-    this->status_.last_freefall_ms = now;
+    this->events_.push(event);
   }
 }
+#endif
 
-void LIS3DHComponent::poll_int2_source_() {
+#ifdef USE_LIS3DH_ORIENTATION_DETECTION
+void LIS3DHComponent::handle_int2_source_(uint8_t raw, uint32_t read_us) {
   RegIntSrc int2_src;
-  // Reading INT2_SRC clears the latched interrupt
-  if (!this->read_byte(static_cast<uint8_t>(RegisterMap::INT2_SRC), &int2_src.raw)) {
+  int2_src.raw = raw;
+  if (!int2_src.ia) {
     return;
   }
 
-  if (!int2_src.ia) {
+#ifdef USE_TEXT_SENSOR
+  // In 6D mode exactly one position bit is set: the axis that points along gravity. Only that
+  // axis' text sensor changes; the other keeps its last known value. Before the first update()
+  // has seeded both there's nothing to compare against, so leave it to update(). High-passed
+  // output can't seed anything, so then every change is published as it comes.
+  if (!this->status_.never_published || this->high_pass_.output) {
+    if (int2_src.x_high) {
+      this->publish_orientation_xy_(OrientationXY::LANDSCAPE_RIGHT);
+    } else if (int2_src.x_low) {
+      this->publish_orientation_xy_(OrientationXY::LANDSCAPE_LEFT);
+    } else if (int2_src.y_high) {
+      this->publish_orientation_xy_(OrientationXY::PORTRAIT_UPRIGHT);
+    } else if (int2_src.y_low) {
+      this->publish_orientation_xy_(OrientationXY::PORTRAIT_UPSIDE_DOWN);
+    } else if (int2_src.z_high) {
+      this->publish_orientation_z_(false);
+    } else if (int2_src.z_low) {
+      this->publish_orientation_z_(true);
+    }
+  }
+#endif
+
+  // Only a new position is an event; the same 6D bits latched again are not
+  uint8_t position = int2_src.raw & 0x3F;
+  if (position == this->status_.orientation_position) {
     return;
   }
+  this->status_.orientation_position = position;
+
+  EventAxis axis = EventAxis::NONE;
+  if (int2_src.x_low || int2_src.x_high) {
+    axis = EventAxis::X;
+  } else if (int2_src.y_low || int2_src.y_high) {
+    axis = EventAxis::Y;
+  } else if (int2_src.z_low || int2_src.z_high) {
+    axis = EventAxis::Z;
+  }
+  ESP_LOGV(TAG, "Orientation change detected");
+  bool negative = int2_src.x_low || int2_src.y_low || int2_src.z_low;
+  this->events_.push(this->make_event_(EventType::ORIENTATION, axis, negative, read_us));
+}
+#endif
 
-  uint32_t now = millis();
-  if (now - this->status_.last_orientation_ms > EVENT_COOLDOWN_MS) {
-    ESP_LOGV(TAG, "Orientation change detected");
-    this->orientation_trigger_.trigger();
-    this->status_.last_orientation_ms = now;
+void LIS3DHComponent::dispatch_events_() {
+  Event event;
+  while (this->events_.pop(event)) {
+    switch (event.type) {
+#ifdef USE_LIS3DH_CLICK_DETECTION
+      case EventType::TAP:
+        this->tap_trigger_.trigger(event);
+        break;
+      case EventType::DOUBLE_TAP:
+        this->double_tap_trigger_.trigger(event);
+        break;
+#endif
+#ifdef USE_LIS3DH_FREEFALL_DETECTION
+      case EventType::FREEFALL:
+        this->freefall_trigger_.trigger(event);
+        break;
+#endif
+#ifdef USE_LIS3DH_ORIENTATION_DETECTION
+      case EventType::ORIENTATION:
+        this->orientation_trigger_.trigger(event);
+        break;
+#endif
+      default:
+        break;
+    }
+  }
+}
+
+// ---- Interrupt pin bookkeeping ----
+
+bool LIS3DHComponent::interrupt_pending_(InternalGPIOPin *pin, InterruptPinStore &store) {
+  // Without a pin there is no way to know, so fall back to polling every loop
+  if (pin == nullptr) {
+    return true;
+  }
+  if (!store.triggered) {
+    return false;
+  }
+  store.triggered = false;
+  return true;
+}
+
+void LIS3DHComponent::rearm_interrupt_(InternalGPIOPin *pin, InterruptPinStore &store) {
+  // A source that latched while we were reading keeps the line high and produces no new
+  // rising edge, so look again on the next pass instead of waiting forever.
+  if (pin != nullptr && pin->digital_read()) {
+    store.triggered = true;
+  }
+}
+
+void LIS3DHComponent::update_sleep_state_() {
+  // INT2_SRC has just been read, so a 6D latch no longer holds the line: if it's still high
+  // the chip is in its inactive 10 Hz low-power state.
+  bool sleeping = this->interrupt2_pin_->digital_read();
+  if (sleeping == this->status_.sleeping) {
+    return;
+  }
+  this->status_.sleeping = sleeping;
+  if (sleeping) {
+    ESP_LOGD(TAG, "No motion, sensor entered low-power sleep");
+  } else {
+    ESP_LOGD(TAG, "Motion detected, sensor back at configured data rate");
+    // Samples produced at 10 Hz during the sleep don't count towards what could have been lost
+    this->acquisition_.last_sample_us = micros();
+    // Pick up whatever arrived while we weren't reading right away
+    this->read_now_ = true;
   }
 }
 
@@ -434,16 +1031,273 @@ void LIS3DHComponent::loop() {
     return;
   }
 
-  if (!this->read_data_()) {
+#ifdef USE_LIS3DH_ACQUISITION_TASK
+  // Every bus transaction happens on the acquisition task; here we only consume its frames and
+  // the source registers it read for us, and submit new source reads
+  BusScheduler::start_task(this->task_core_, this->task_priority_);
+  RawFrame frame;
+  while (this->frames_.pop(frame)) {
+    this->drain_block_.push(frame.x, frame.y, frame.z);
+    if (this->drain_block_.full()) {
+      this->process_block_(this->drain_block_);
+      this->drain_block_.clear();
+    }
+  }
+  this->process_block_(this->drain_block_);
+  this->drain_block_.clear();
+  this->collect_sources_();
+  this->collect_image_check_();
+#else
+  // All bus traffic goes through the scheduler, driven by the first working instance on each bus
+  if (this->scheduler_->is_owner(this)) {
+    this->scheduler_->run();
+  }
+#endif
+
+  if (this->bus_error_) {
     this->status_set_warning();
+  } else {
+    this->status_clear_warning();
+  }
+
+  this->dispatch_events_();
+
+#if defined(USE_SENSOR) && defined(USE_LIS3DH_SPECTRUM)
+  // FFT work is split across passes and never takes longer than its time budget
+  if (this->spectrum_enabled_) {
+    this->spectrum_.loop();
+  }
+#endif
+}
+
+void LIS3DHComponent::service_bus_() {
+  this->bus_error_ = !this->acquire_();
+  if (this->bus_error_) {
     return;
   }
+#ifdef USE_LIS3DH_ACQUISITION_TASK
+  this->serve_source_reads_();
+  this->serve_image_check_();
+#else
+  this->poll_sources_();
+#endif
+}
+
+bool LIS3DHComponent::acquire_() {
+  // Skip the bus until the chip can have produced new data. If a read comes back empty the
+  // chip's clock is running slightly behind ours, so retry half a sample period later.
+  // While the chip sleeps the output registers only hold low-power 10 Hz data, so don't read them at all.
+  uint32_t now = micros();
+  bool due = this->read_now_.exchange(false) ||
+             now - this->acquisition_.last_read_us >= this->acquisition_.read_interval_us;
+  if (this->status_.sleeping || this->acquisition_.read_interval_us == 0 || !due) {
+    return true;
+  }
 
-  this->poll_click_source_();
-  this->poll_int1_source_();
-  this->poll_int2_source_();
+  uint32_t frames_before = this->acquisition_.frames_read;
+  uint32_t overruns_before = this->status_.data_overruns + this->status_.fifo_overruns;
+  if (!this->read_data_()) {
+    return false;
+  }
+  if (this->status_.data_overruns + this->status_.fifo_overruns != overruns_before) {
+    // The chip overwrote samples we never saw. It produced one per period since the last read,
+    // so whatever didn't come back now is gone (at least one, or the flag wouldn't be set).
+    uint32_t produced = (now - this->acquisition_.last_sample_us) / this->acquisition_.sample_period_us;
+    uint32_t frames = this->acquisition_.frames_read - frames_before;
+    this->acquisition_.samples_lost += produced > frames ? produced - frames : 1;
+  }
+  if (this->acquisition_.frames_read != frames_before) {
+    this->acquisition_.last_read_us = now;
+    this->acquisition_.last_sample_us = now;
+  } else {
+    this->acquisition_.last_read_us =
+        now - this->acquisition_.read_interval_us + this->acquisition_.sample_period_us / 2;
+  }
+  return true;
+}
 
-  this->status_clear_warning();
+uint8_t LIS3DHComponent::line_sources_(uint8_t line) const {
+  // INT1 carries click and freefall, INT2 carries 6D orientation (and the sleep-to-wake state,
+  // which has no source register). Sources of detectors this instance doesn't use are never read.
+  uint8_t sources = 0;
+  if (line == 1) {
+#ifdef USE_LIS3DH_CLICK_DETECTION
+    if (this->detectors_.click)
+      sources |= 1 << SOURCE_CLICK;
+#endif
+#ifdef USE_LIS3DH_FREEFALL_DETECTION
+    if (this->detectors_.freefall)
+      sources |= 1 << SOURCE_INT1;
+#endif
+  } else {
+#ifdef USE_LIS3DH_ORIENTATION_DETECTION
+    if (this->detectors_.orientation)
+      sources |= 1 << SOURCE_INT2;
+#endif
+  }
+  return sources;
+}
+
+void LIS3DHComponent::handle_source_(uint8_t source, [[maybe_unused]] uint8_t raw, [[maybe_unused]] uint32_t read_us) {
+  switch (source) {
+#ifdef USE_LIS3DH_CLICK_DETECTION
+    case SOURCE_CLICK:
+      this->handle_click_source_(raw, read_us);
+      break;
+#endif
+#ifdef USE_LIS3DH_FREEFALL_DETECTION
+    case SOURCE_INT1:
+      this->handle_int1_source_(raw, read_us);
+      break;
+#endif
+#ifdef USE_LIS3DH_ORIENTATION_DETECTION
+    case SOURCE_INT2:
+      this->handle_int2_source_(raw, read_us);
+      break;
+#endif
+    default:
+      break;
+  }
+}
+
+void LIS3DHComponent::finish_line2_() {
+  if (this->inactivity_duration_ms_ > 0) {
+    // The line stays high for the whole sleep; the wake-up arrives as a falling edge
+    this->update_sleep_state_();
+  } else {
+    this->rearm_interrupt_(this->interrupt2_pin_, this->interrupt2_store_);
+  }
+}
+
+#ifdef USE_LIS3DH_ACQUISITION_TASK
+void LIS3DHComponent::collect_sources_() {
+  // Reads the task completed since the last pass. Reading cleared the latches, so the lines can be
+  // re-armed now; a source that latched again meanwhile keeps its line high and is requested again.
+  uint8_t line1 = this->line_sources_(1);
+  uint8_t line2 = this->line_sources_(2);
+  uint8_t completed = this->source_reads_.completed.exchange(0, std::memory_order_acquire);
+  for (uint8_t source = 0; source < SOURCE_COUNT; source++) {
+    if (completed & (1 << source)) {
+      this->handle_source_(source, this->source_reads_.values[source], this->source_reads_.read_us[source]);
+    }
+  }
+  if (completed & line1) {
+    this->rearm_interrupt_(this->interrupt1_pin_, this->interrupt1_store_);
+  }
+  if (completed & line2) {
+    this->finish_line2_();
+  }
+
+  // Submit reads for lines that fired; a line whose read is still on the wire waits for it
+  uint8_t in_flight = this->source_reads_.requested.load(std::memory_order_relaxed);
+  uint8_t submit = 0;
+  if (!(in_flight & line1) && this->interrupt_pending_(this->interrupt1_pin_, this->interrupt1_store_)) {
+    if (line1 != 0) {
+      submit |= line1;
+    } else {
+      this->rearm_interrupt_(this->interrupt1_pin_, this->interrupt1_store_);
+    }
+  }
+  if (!(in_flight & line2) && this->interrupt_pending_(this->interrupt2_pin_, this->interrupt2_store_)) {
+    if (line2 != 0) {
+      submit |= line2;
+    } else {
+      this->finish_line2_();
+    }
+  }
+  if (submit != 0) {
+    this->source_reads_.requested.fetch_or(submit, std::memory_order_release);
+  }
+}
+
+void LIS3DHComponent::serve_source_reads_() {
+  // Runs on the task: performs the reads loop() submitted and hands the raw values back.
+  // A failed read stays requested and is retried on the next pass.
+  uint8_t requested = this->source_reads_.requested.load(std::memory_order_acquire);
+  if (requested == 0) {
+    return;
+  }
+  uint8_t done = 0;
+  for (uint8_t source = 0; source < SOURCE_COUNT; source++) {
+    if (!(requested & (1 << source))) {
+      continue;
+    }
+    if (this->read_register_(SOURCE_REGISTERS[source], &this->source_reads_.values[source])) {
+      this->source_reads_.read_us[source] = micros();
+      done |= 1 << source;
+    }
+  }
+  // Completed before no longer requested, so loop() never sees a source as neither
+  this->source_reads_.completed.fetch_or(done, std::memory_order_release);
+  this->source_reads_.requested.fetch_and(~done, std::memory_order_release);
+}
+
+void LIS3DHComponent::collect_image_check_() {
+  if (this->image_check_.completed.load(std::memory_order_acquire)) {
+    this->report_register_image_(this->image_check_.result, this->image_check_.found_ctrl1);
+    this->image_check_.completed.store(false, std::memory_order_release);
+  }
+}
+
+void LIS3DHComponent::serve_image_check_() {
+  // Runs on the task. A result loop() hasn't reported yet is left alone; the check runs once it has.
+  if (!this->image_check_.requested.load(std::memory_order_acquire) ||
+      this->image_check_.completed.load(std::memory_order_acquire)) {
+    return;
+  }
+  this->image_check_.result = this->repair_register_image_(&this->image_check_.found_ctrl1);
+  // Completed before no longer requested, like the source reads
+  this->image_check_.completed.store(true, std::memory_order_release);
+  this->image_check_.requested.store(false, std::memory_order_release);
+}
+#else
+void LIS3DHComponent::poll_sources_() {
+  // Without the acquisition task the reads complete synchronously in the bus scheduler's pass
+  if (this->interrupt_pending_(this->interrupt1_pin_, this->interrupt1_store_)) {
+    this->read_sources_(this->line_sources_(1));
+    this->rearm_interrupt_(this->interrupt1_pin_, this->interrupt1_store_);
+  }
+  if (this->interrupt_pending_(this->interrupt2_pin_, this->interrupt2_store_)) {
+    this->read_sources_(this->line_sources_(2));
+    this->finish_line2_();
+  }
+}
+
+void LIS3DHComponent::read_sources_(uint8_t sources) {
+  for (uint8_t source = 0; source < SOURCE_COUNT; source++) {
+    uint8_t raw;
+    // Reading a source register clears its latched interrupt
+    if ((sources & (1 << source)) && this->read_register_(SOURCE_REGISTERS[source], &raw)) {
+      this->handle_source_(source, raw, micros());
+    }
+  }
+}
+#endif
+
+bool LIS3DHComponent::read_registers_(RegisterMap reg, uint8_t *data, size_t len) {
+#ifdef USE_LIS3DH_ACQUISITION_TASK
+  LockGuard guard(this->scheduler_->get_lock());
+#endif
+  uint32_t start = micros();
+  bool ok = this->bus_read_(reg, data, len);
+  this->bus_time_us_ += micros() - start;
+  if (!ok) {
+    this->status_.bus_errors++;
+  }
+  return ok;
+}
+
+bool LIS3DHComponent::write_registers_(RegisterMap reg, const uint8_t *data, size_t len) {
+#ifdef USE_LIS3DH_ACQUISITION_TASK
+  LockGuard guard(this->scheduler_->get_lock());
+#endif
+  uint32_t start = micros();
+  bool ok = this->bus_write_(reg, data, len);
+  this->bus_time_us_ += micros() - start;
+  if (!ok) {
+    this->status_.bus_errors++;
+  }
+  return ok;
 }
 
 void LIS3DHComponent::update() {
@@ -451,45 +1305,274 @@ void LIS3DHComponent::update() {
     return;
   }
 
-  ESP_LOGV(TAG, "Acceleration: {x = %+1.3f m/s², y = %+1.3f m/s², z = %+1.3f m/s²}", this->data_.x, this->data_.y,
-           this->data_.z);
+  this->check_register_image_();
 
 #ifdef USE_SENSOR
-  if (this->acceleration_x_sensor_ != nullptr)
-    this->acceleration_x_sensor_->publish_state(this->data_.x);
-  if (this->acceleration_y_sensor_ != nullptr)
-    this->acceleration_y_sensor_->publish_state(this->data_.y);
-  if (this->acceleration_z_sensor_ != nullptr)
-    this->acceleration_z_sensor_->publish_state(this->data_.z);
+  if (this->bus_utilization_sensor_ != nullptr) {
+    // Share of wall time since the last publish that any LIS3DH instance on this bus spent in a
+    // transaction; other devices on the bus are invisible here, so this is a lower bound of its load
+    uint32_t now = micros();
+    uint32_t busy = this->scheduler_->get_busy_us();
+    if (this->last_utilization_us_ != 0 && now != this->last_utilization_us_) {
+      this->bus_utilization_sensor_->publish_state(100.0f * (busy - this->last_busy_us_) /
+                                                   (now - this->last_utilization_us_));
+    }
+    this->last_busy_us_ = busy;
+    this->last_utilization_us_ = now;
+  }
+  if (this->samples_read_sensor_ != nullptr)
+    this->samples_read_sensor_->publish_state(this->acquisition_.samples_read);
+  if (this->samples_lost_sensor_ != nullptr)
+    this->samples_lost_sensor_->publish_state(this->get_samples_lost_());
+  if (this->bus_errors_sensor_ != nullptr)
+    this->bus_errors_sensor_->publish_state(this->status_.bus_errors.load());
+  if (this->events_dropped_sensor_ != nullptr)
+    this->events_dropped_sensor_->publish_state(this->events_.get_overflows());
+
+#ifdef USE_LIS3DH_DEADBAND
+  bool publish_acceleration = this->deadband_exceeded_();
+#else
+  bool publish_acceleration = true;
+#endif
+  if (publish_acceleration) {
+    float accel_x = this->data_.x * this->scale_;
+    float accel_y = this->data_.y * this->scale_;
+    float accel_z = this->data_.z * this->scale_;
+
+    ESP_LOGV(TAG, "Acceleration: {x = %+1.3f m/s², y = %+1.3f m/s², z = %+1.3f m/s²}", accel_x, accel_y, accel_z);
+
+    if (this->acceleration_x_sensor_ != nullptr)
+      this->acceleration_x_sensor_->publish_state(accel_x);
+    if (this->acceleration_y_sensor_ != nullptr)
+      this->acceleration_y_sensor_->publish_state(accel_y);
+    if (this->acceleration_z_sensor_ != nullptr)
+      this->acceleration_z_sensor_->publish_state(accel_z);
+  }
+#ifdef USE_LIS3DH_INCLINOMETER
+  this->publish_inclination_();
+#endif
+#ifdef USE_LIS3DH_MOTION_MAGNITUDE
+  if (this->motion_magnitude_sensor_ != nullptr && this->motion_.count() > 0) {
+    this->motion_magnitude_sensor_->publish_state(this->motion_.get(StatsKind::RMS) * this->sensitivity_ *
+                                                  GRAVITY_EARTH);
+    this->motion_.reset();
+  }
+#endif
+#ifdef USE_LIS3DH_STATISTICS
+  this->publish_statistics_();
+#endif
+#ifdef USE_LIS3DH_SPECTRUM
+  if (this->spectrum_enabled_) {
+    this->spectrum_.publish();
+  }
+#endif
 #endif
 
-#ifdef USE_TEXT_SENSOR
-  // Derive orientation from current acceleration data
-  float abs_x = fabsf(this->data_.x);
-  float abs_y = fabsf(this->data_.y);
-  float abs_z = fabsf(this->data_.z);
+#ifdef USE_LIS3DH_PEDOMETER
+  this->publish_pedometer_();
+#endif
+
+#if defined(USE_TEXT_SENSOR) && defined(USE_LIS3DH_ORIENTATION_DETECTION)
+  // High-passed output has no gravity to go by, so then the first 6D change has to do
+  if (this->status_.never_published && this->detectors_.orientation && !this->high_pass_.output) {
+    this->seed_orientation_();
+  }
+#endif
+}
+
+#if defined(USE_TEXT_SENSOR) && defined(USE_LIS3DH_ORIENTATION_DETECTION)
+void LIS3DHComponent::seed_orientation_() {
+  // The 6D generator only reports changes, so seed the initial orientation from the acceleration
+  // data; after that INT2_SRC keeps it current (the sign and ratio are scale-independent).
+  int32_t x = this->data_.x;
+  int32_t y = this->data_.y;
+  int32_t z = this->data_.z;
+  if (this->acquisition_.read_interval_us == 0) {
+    // Nothing reads the sample stream on this instance, so fetch the one frame the seed needs
+    uint8_t frame[FRAME_SIZE];
+    if (!this->read_registers_(RegisterMap::OUT_X_L, frame, sizeof(frame))) {
+      return;
+    }
+    SampleBlock<1> block;
+    block.decode(frame, 1);
+    x = block.x[0];
+    y = block.y[0];
+    z = block.z[0];
+  }
 
   OrientationXY new_xy;
-  if (abs_x > abs_y) {
-    new_xy = (this->data_.x > 0) ? OrientationXY::LANDSCAPE_RIGHT : OrientationXY::LANDSCAPE_LEFT;
+  if (std::abs(x) > std::abs(y)) {
+    new_xy = (x > 0) ? OrientationXY::LANDSCAPE_RIGHT : OrientationXY::LANDSCAPE_LEFT;
   } else {
-    new_xy = (this->data_.y > 0) ? OrientationXY::PORTRAIT_UPRIGHT : OrientationXY::PORTRAIT_UPSIDE_DOWN;
+    new_xy = (y > 0) ? OrientationXY::PORTRAIT_UPRIGHT : OrientationXY::PORTRAIT_UPSIDE_DOWN;
+  }
+  this->publish_orientation_xy_(new_xy);
+  this->publish_orientation_z_(z < 0);  // true = downwards looking
+  this->status_.never_published = false;
+}
+
+void LIS3DHComponent::publish_orientation_xy_(OrientationXY orientation) {
+  if (orientation == this->status_.orientation_xy && !this->status_.never_published) {
+    return;
   }
-  bool new_z = (this->data_.z < 0);  // true = downwards looking
+  this->status_.orientation_xy = orientation;
+  if (this->orientation_xy_text_sensor_ != nullptr) {
+    this->orientation_xy_text_sensor_->publish_state(orientation_xy_to_string(orientation));
+  }
+}
 
-  if (this->orientation_xy_text_sensor_ != nullptr &&
-      (new_xy != this->status_.orientation_xy || this->status_.never_published)) {
-    this->orientation_xy_text_sensor_->publish_state(orientation_xy_to_string(new_xy));
+void LIS3DHComponent::publish_orientation_z_(bool downwards) {
+  if (downwards == this->status_.orientation_z && !this->status_.never_published) {
+    return;
   }
-  if (this->orientation_z_text_sensor_ != nullptr &&
-      (new_z != this->status_.orientation_z || this->status_.never_published)) {
-    this->orientation_z_text_sensor_->publish_state(orientation_z_to_string(new_z));
+  this->status_.orientation_z = downwards;
+  if (this->orientation_z_text_sensor_ != nullptr) {
+    this->orientation_z_text_sensor_->publish_state(orientation_z_to_string(downwards));
   }
+}
+#endif
 
-  this->status_.orientation_xy = new_xy;
-  this->status_.orientation_z = new_z;
-  this->status_.never_published = false;
+#if defined(USE_SENSOR) && defined(USE_LIS3DH_DEADBAND)
+bool LIS3DHComponent::deadband_exceeded_() {
+  auto &db = this->deadband_;
+  if (!db.enabled) {
+    return true;
+  }
+  uint32_t now = millis();
+  int32_t dx = this->data_.x - db.last_x;
+  int32_t dy = this->data_.y - db.last_y;
+  int32_t dz = this->data_.z - db.last_z;
+
+  bool exceeded = !db.published;
+  if (db.axis_threshold_q > 0) {
+    exceeded |= std::abs(dx) > db.axis_threshold_q || std::abs(dy) > db.axis_threshold_q ||
+                std::abs(dz) > db.axis_threshold_q;
+  }
+  if (db.vector_threshold_sq > 0) {
+    int64_t distance_sq = static_cast<int64_t>(dx) * dx + static_cast<int64_t>(dy) * dy + static_cast<int64_t>(dz) * dz;
+    exceeded |= distance_sq > db.vector_threshold_sq;
+  }
+  if (db.axis_threshold_q == 0 && db.vector_threshold_sq == 0) {
+    exceeded |= dx != 0 || dy != 0 || dz != 0;
+  }
+  if (db.max_silence_ms > 0) {
+    exceeded |= now - db.last_publish_ms >= db.max_silence_ms;
+  }
+
+  if (!exceeded) {
+    db.suppressed++;
+    return false;
+  }
+  // All three axes go out together, so the reference point is always a published vector
+  db.last_x = this->data_.x;
+  db.last_y = this->data_.y;
+  db.last_z = this->data_.z;
+  db.last_publish_ms = now;
+  db.published = true;
+  return true;
+}
 #endif
+
+#if defined(USE_SENSOR) && defined(USE_LIS3DH_INCLINOMETER)
+void LIS3DHComponent::update_inclination_() {
+  // Keep 4 fractional bits and clamp to ±2^15, as a filter can overshoot full scale; a sum of two
+  // squares then fits in 32 bits. About 3 table lookups and 2 integer square roots, cheap enough
+  // to run on every filter pass.
+  int32_t x = std::clamp<int32_t>(this->data_.x >> (SAMPLE_FRACTION_BITS - 4), -32767, 32767);
+  int32_t y = std::clamp<int32_t>(this->data_.y >> (SAMPLE_FRACTION_BITS - 4), -32767, 32767);
+  int32_t z = std::clamp<int32_t>(this->data_.z >> (SAMPLE_FRACTION_BITS - 4), -32767, 32767);
+  int32_t yz = isqrt32(static_cast<uint32_t>(y * y) + static_cast<uint32_t>(z * z));
+  int32_t xy = isqrt32(static_cast<uint32_t>(x * x) + static_cast<uint32_t>(y * y));
+  // Roll about X, pitch of the X axis out of the horizontal (AN3461 convention), tilt of Z from vertical (0–180°)
+  auto &inc = this->inclination_;
+  inc.roll = atan2_cdeg(y, z);
+  inc.pitch = atan2_cdeg(-x, yz);
+  inc.tilt = atan2_cdeg(xy, z);
+}
+
+void LIS3DHComponent::publish_inclination_() {
+  auto &inc = this->inclination_;
+  uint32_t now = millis();
+  bool exceeded = !inc.published || std::abs(inc.pitch - inc.last_pitch) > inc.threshold_cdeg ||
+                  std::abs(inc.roll - inc.last_roll) > inc.threshold_cdeg ||
+                  std::abs(inc.tilt - inc.last_tilt) > inc.threshold_cdeg;
+  if (inc.max_silence_ms > 0) {
+    exceeded |= now - inc.last_publish_ms >= inc.max_silence_ms;
+  }
+  if (!exceeded) {
+    return;
+  }
+  inc.last_pitch = inc.pitch;
+  inc.last_roll = inc.roll;
+  inc.last_tilt = inc.tilt;
+  inc.last_publish_ms = now;
+  inc.published = true;
+
+  if (this->pitch_sensor_ != nullptr)
+    this->pitch_sensor_->publish_state(inc.pitch / 100.0f);
+  if (this->roll_sensor_ != nullptr)
+    this->roll_sensor_->publish_state(inc.roll / 100.0f);
+  if (this->tilt_sensor_ != nullptr)
+    this->tilt_sensor_->publish_state(inc.tilt / 100.0f);
+}
+#endif
+
+#if defined(USE_SENSOR) && defined(USE_LIS3DH_STATISTICS)
+void LIS3DHComponent::publish_statistics_() {
+  // Statistics are accumulated in raw digits
+  float digit_scale = this->sensitivity_ * GRAVITY_EARTH;
+
+  for (uint8_t channel = 0; channel < SAMPLE_CHANNEL_COUNT; channel++) {
+    WindowStats &stats = this->statistics_[channel];
+    if (stats.count() > 0) {
+      for (uint8_t kind = 0; kind < STATS_KIND_COUNT; kind++) {
+        sensor::Sensor *sens = this->statistics_sensors_[channel][kind];
+        if (sens != nullptr)
+          sens->publish_state(stats.get(static_cast<StatsKind>(kind)) * digit_scale);
+      }
+    }
+    stats.reset();
+  }
+}
+#endif
+
+#ifdef USE_LIS3DH_PEDOMETER
+void LIS3DHComponent::publish_pedometer_() {
+  // Both change a few times a minute at most, so only changes go out
+  auto &pedometer = this->pedometer_;
+  uint32_t steps = pedometer.detector.get_steps();
+  Activity activity = pedometer.detector.get_activity();
+  if (pedometer.published && steps == pedometer.last_steps && activity == pedometer.last_activity) {
+    return;
+  }
+#ifdef USE_SENSOR
+  if (this->step_count_sensor_ != nullptr && (!pedometer.published || steps != pedometer.last_steps))
+    this->step_count_sensor_->publish_state(steps);
+#endif
+#ifdef USE_TEXT_SENSOR
+  if (this->activity_text_sensor_ != nullptr && (!pedometer.published || activity != pedometer.last_activity))
+    this->activity_text_sensor_->publish_state(activity_to_string(activity));
+#endif
+  pedometer.last_steps = steps;
+  pedometer.last_activity = activity;
+  pedometer.published = true;
+}
+#endif
+
+uint32_t LIS3DHComponent::get_samples_lost_() const {
+  uint32_t lost = this->acquisition_.samples_lost.load();
+#ifdef USE_LIS3DH_ACQUISITION_TASK
+  // Frames the task read but loop() couldn't take in time
+  lost += this->frames_.get_dropped();
+#endif
+  return lost;
+}
+
+float LIS3DHComponent::get_output_data_rate_() const {
+  if (this->data_rate_ == DataRate::ODR_1344HZ_5376HZ_LP && this->resolution_ == Resolution::RES_LOW_POWER) {
+    return LOW_POWER_TOP_RATE_HZ;
+  }
+  return DATA_RATE_HZ[static_cast<uint8_t>(this->data_rate_)];
 }
 
 float LIS3DHComponent::get_setup_priority() const { return setup_priority::DATA; }
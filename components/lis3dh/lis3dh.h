@@ -1,15 +1,32 @@
 #pragma once
 
 #include "esphome/core/component.h"
-#include "esphome/components/i2c/i2c.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/helpers.h"
 #include "esphome/core/automation.h"
 
+#include "lis3dh_bus_scheduler.h"
+#include "lis3dh_events.h"
+#include "lis3dh_filters.h"
+#include "lis3dh_goertzel.h"
+#include "lis3dh_math.h"
+#include "lis3dh_pedometer.h"
+#include "lis3dh_ring.h"
+#include "lis3dh_sample_block.h"
+#include "lis3dh_spectrum.h"
+#include "lis3dh_stats.h"
+
+#include <atomic>
+
 #ifdef USE_SENSOR
 #include "esphome/components/sensor/sensor.h"
 #endif
 #ifdef USE_TEXT_SENSOR
 #include "esphome/components/text_sensor/text_sensor.h"
 #endif
+#ifdef USE_BINARY_SENSOR
+#include "esphome/components/binary_sensor/binary_sensor.h"
+#endif
 
 namespace esphome {
 namespace lis3dh {
@@ -17,8 +34,21 @@ namespace lis3dh {
 /// LIS3DH chip ID returned by WHO_AM_I register
 static const uint8_t LIS3DH_CHIP_ID = 0x33;
 
-/// I2C auto-increment flag — must be OR'd into the register address for multi-byte reads
-static const uint8_t I2C_AUTO_INCREMENT = 0x80;
+/// Depth of the on-chip FIFO in X/Y/Z frames
+static const uint8_t FIFO_DEPTH = 32;
+
+/// One output frame in raw digits, as handed from the acquisition task to loop()
+struct RawFrame {
+  int16_t x;
+  int16_t y;
+  int16_t z;
+};
+
+/// Frames buffered between the acquisition task and loop(): ~24 ms at 5.376 kHz
+static const size_t FRAME_RING_SIZE = 128;
+
+/// Fractional bits of the Q-format filter state (12-bit counts << 8 still fits comfortably in int32)
+static const uint8_t SAMPLE_FRACTION_BITS = 8;
 
 // ---- Register Map ----
 
@@ -60,6 +90,8 @@ enum class RegisterMap : uint8_t {
   TIME_LIMIT = 0x3B,
   TIME_LATENCY = 0x3C,
   TIME_WINDOW = 0x3D,
+  ACT_THS = 0x3E,
+  ACT_DUR = 0x3F,
 };
 
 // ---- Configuration Enums ----
@@ -80,6 +112,15 @@ enum class DataRate : uint8_t {
   ODR_100HZ = 0b0101,
   ODR_200HZ = 0b0110,
   ODR_400HZ = 0b0111,
+  ODR_1600HZ_LP = 0b1000,        // low-power mode only
+  ODR_1344HZ_5376HZ_LP = 0b1001,  // 1.344 kHz in normal/high-res, 5.376 kHz in low-power mode
+};
+
+enum class FifoMode : uint8_t {
+  BYPASS = 0b00,
+  FIFO = 0b01,
+  STREAM = 0b10,
+  STREAM_TO_FIFO = 0b11,
 };
 
 enum class Resolution : uint8_t {
@@ -102,6 +143,19 @@ union RegCtrl1 {
   uint8_t raw{0x00};
 };
 
+// CTRL_REG2 (0x21) — Internal high-pass filter
+union RegCtrl2 {
+  struct {
+    bool hp_ia1 : 1;    // bit 0   — High-pass filter on interrupt generator 1
+    bool hp_ia2 : 1;    // bit 1   — High-pass filter on interrupt generator 2
+    bool hpclick : 1;   // bit 2   — High-pass filter on the click function
+    bool fds : 1;       // bit 3   — Filtered data to the output registers and FIFO
+    uint8_t hpcf : 2;   // bit 5:4 — Cutoff, roughly ODR/50 >> HPCF
+    uint8_t hpm : 2;    // bit 7:6 — Filter mode (00 = normal, reset by reading REFERENCE)
+  } __attribute__((packed));
+  uint8_t raw{0x00};
+};
+
 // CTRL_REG3 (0x22) — Interrupt control on INT1 pin
 union RegCtrl3 {
   struct {
@@ -117,6 +171,21 @@ union RegCtrl3 {
   uint8_t raw{0x00};
 };
 
+// CTRL_REG6 (0x25) — Interrupt control on INT2 pin
+union RegCtrl6 {
+  struct {
+    uint8_t unused0 : 1;     // bit 0
+    bool int_polarity : 1;   // bit 1 — Interrupt active low (0 = active high)
+    uint8_t unused2 : 1;     // bit 2
+    bool i2_act : 1;         // bit 3 — Activity interrupt on INT2
+    bool i2_boot : 1;        // bit 4 — Boot on INT2
+    bool i2_ia2 : 1;         // bit 5 — Interrupt generator 2 on INT2
+    bool i2_ia1 : 1;         // bit 6 — Interrupt generator 1 on INT2
+    bool i2_click : 1;       // bit 7 — Click on INT2
+  } __attribute__((packed));
+  uint8_t raw{0x00};
+};
+
 // CTRL_REG4 (0x23)
 union RegCtrl4 {
   struct {
@@ -144,6 +213,42 @@ union RegCtrl5 {
   uint8_t raw{0x00};
 };
 
+// STATUS_REG (0x27)
+union RegStatus {
+  struct {
+    bool xda : 1;    // bit 0 — X new data available
+    bool yda : 1;    // bit 1 — Y new data available
+    bool zda : 1;    // bit 2 — Z new data available
+    bool zyxda : 1;  // bit 3 — X, Y and Z new data available
+    bool x_or : 1;   // bit 4 — X data overrun
+    bool y_or : 1;   // bit 5 — Y data overrun
+    bool z_or : 1;   // bit 6 — Z data overrun
+    bool zyxor : 1;  // bit 7 — X, Y and Z data overrun
+  } __attribute__((packed));
+  uint8_t raw{0x00};
+};
+
+// FIFO_CTRL (0x2E)
+union RegFifoCtrl {
+  struct {
+    uint8_t fth : 5;    // bit 4:0 — FIFO watermark threshold
+    bool tr : 1;        // bit 5   — Trigger selection (INT1/INT2)
+    FifoMode fm : 2;    // bit 7:6 — FIFO mode
+  } __attribute__((packed));
+  uint8_t raw{0x00};
+};
+
+// FIFO_SRC (0x2F)
+union RegFifoSrc {
+  struct {
+    uint8_t fss : 5;   // bit 4:0 — Number of unread frames in FIFO
+    bool empty : 1;    // bit 5   — FIFO empty
+    bool ovrn : 1;     // bit 6   — FIFO overrun (all 32 slots filled)
+    bool wtm : 1;      // bit 7   — Watermark level reached
+  } __attribute__((packed));
+  uint8_t raw{0x00};
+};
+
 // INTx_CFG (0x30 / 0x34) — Interrupt generator configuration
 union RegIntCfg {
   struct {
@@ -203,6 +308,27 @@ union RegClickSrc {
   uint8_t raw{0x00};
 };
 
+// ---- Register image ----
+
+/// Every register setup() configures except FIFO_CTRL, laid out as the chip's three auto-increment
+/// blocks so it goes out in three bursts and can be compared against a read-back
+struct RegisterImage {
+  uint8_t ctrl[6]{};       // CTRL_REG1..CTRL_REG6 (0x20–0x25)
+  uint8_t interrupt[8]{};  // INT1_CFG..INT2_DUR (0x30–0x37)
+  uint8_t click[8]{};      // CLICK_CFG..ACT_DUR (0x38–0x3F)
+
+  uint8_t &at(RegisterMap reg) {
+    uint8_t addr = static_cast<uint8_t>(reg);
+    if (addr >= static_cast<uint8_t>(RegisterMap::CLICK_CFG))
+      return this->click[addr - static_cast<uint8_t>(RegisterMap::CLICK_CFG)];
+    if (addr >= static_cast<uint8_t>(RegisterMap::INT1_CFG))
+      return this->interrupt[addr - static_cast<uint8_t>(RegisterMap::INT1_CFG)];
+    return this->ctrl[addr - static_cast<uint8_t>(RegisterMap::CTRL_REG1)];
+  }
+  void set(RegisterMap reg, uint8_t value) { this->at(reg) = value; }
+  uint8_t get(RegisterMap reg) { return this->at(reg); }
+};
+
 // ---- Orientation (derived from acceleration data) ----
 
 enum class OrientationXY : uint8_t {
@@ -212,9 +338,36 @@ enum class OrientationXY : uint8_t {
   LANDSCAPE_RIGHT = 3,
 };
 
+// ---- Interrupt pin handling ----
+
+/// Source registers read after an interrupt, as bit positions in a source mask
+enum EventSource : uint8_t {
+  SOURCE_CLICK = 0,
+  SOURCE_INT1 = 1,
+  SOURCE_INT2 = 2,
+  SOURCE_COUNT = 3,
+};
+
+/// What a check of CTRL_REG1..6 against the register image found
+enum class ImageCheck : uint8_t {
+  READ_FAILED,
+  INTACT,
+  REAPPLIED,
+  REAPPLY_FAILED,
+};
+
+/// Set from the INTx pin ISR and consumed by loop() to decide which source registers to read
+struct InterruptPinStore {
+  volatile bool triggered{true};
+
+  static void gpio_intr(InterruptPinStore *arg);
+};
+
 // ---- Component Class ----
 
-class LIS3DHComponent : public PollingComponent, public i2c::I2CDevice {
+/// Bus-independent part of the driver. The I2C and SPI variants only provide register access;
+/// multi-byte accesses always auto-increment the register address.
+class LIS3DHComponent : public PollingComponent {
  public:
   void setup() override;
   void dump_config() override;
@@ -222,9 +375,48 @@ class LIS3DHComponent : public PollingComponent, public i2c::I2CDevice {
   void update() override;
   float get_setup_priority() const override;
 
+  /// Microseconds this instance has spent in bus transactions (wraps)
+  uint32_t get_bus_time_us() const { return this->bus_time_us_; }
+
   void set_range(Range range) { this->range_ = range; }
   void set_data_rate(DataRate data_rate) { this->data_rate_ = data_rate; }
   void set_resolution(Resolution resolution) { this->resolution_ = resolution; }
+  void set_fifo_watermark(uint8_t fifo_watermark) { this->fifo_watermark_ = fifo_watermark; }
+  void set_bus_time_budget(uint32_t time_budget_us) { this->bus_time_budget_us_ = time_budget_us; }
+#ifdef USE_LIS3DH_ACQUISITION_TASK
+  void set_acquisition_task(uint8_t core, uint8_t priority) {
+    this->task_core_ = core;
+    this->task_priority_ = priority;
+  }
+#endif
+#ifdef USE_LIS3DH_MEDIAN_FILTER
+  void set_median_window(uint8_t window) { this->filter_config_.median_window = window; }
+#endif
+#ifdef USE_LIS3DH_MOVING_AVERAGE_FILTER
+  void set_moving_average_window(uint8_t window) { this->filter_config_.moving_average_window = window; }
+#endif
+#ifdef USE_LIS3DH_EMA_FILTER
+  void set_ema_alpha(float alpha) { this->filter_config_.ema_alpha = alpha; }
+#endif
+#ifdef USE_LIS3DH_BIQUAD_FILTER
+  void set_biquad(BiquadType type, float cutoff, float q) {
+    this->filter_config_.biquad_type = type;
+    this->filter_config_.biquad_cutoff = cutoff;
+    this->filter_config_.biquad_q = q;
+  }
+#endif
+  void set_inactivity(float threshold, uint32_t duration_ms) {
+    this->inactivity_threshold_ = threshold;
+    this->inactivity_duration_ms_ = duration_ms;
+  }
+  /// Chip-internal high-pass filter with cutoff ≈ ODR/50 >> cutoff, on the output data and/or the click engine
+  void set_high_pass(uint8_t cutoff, bool output, bool click) {
+    this->high_pass_.cutoff = cutoff;
+    this->high_pass_.output = output;
+    this->high_pass_.click = click;
+  }
+  void set_interrupt1_pin(InternalGPIOPin *pin) { this->interrupt1_pin_ = pin; }
+  void set_interrupt2_pin(InternalGPIOPin *pin) { this->interrupt2_pin_ = pin; }
 
 #ifdef USE_SENSOR
   SUB_SENSOR(acceleration_x)
@@ -232,54 +424,404 @@ class LIS3DHComponent : public PollingComponent, public i2c::I2CDevice {
   SUB_SENSOR(acceleration_z)
 #endif
 
+#ifdef USE_SENSOR
+  /// LIS3DH share of bus time; other devices on the bus aren't included
+  SUB_SENSOR(bus_utilization)
+  SUB_SENSOR(samples_read)
+  SUB_SENSOR(samples_lost)
+  SUB_SENSOR(bus_errors)
+  SUB_SENSOR(events_dropped)
+#endif
+
+#if defined(USE_SENSOR) && defined(USE_LIS3DH_MOTION_MAGNITUDE)
+  SUB_SENSOR(motion_magnitude)
+#endif
+
+#if defined(USE_SENSOR) && defined(USE_LIS3DH_DEADBAND)
+  /// Publish acceleration only when an axis moves by more than axis_threshold or the vector by more than
+  /// vector_threshold (m/s², 0 = unused; both unused = any change), or max_silence_ms has passed since the
+  /// last publish (0 = never)
+  void set_deadband(float axis_threshold, float vector_threshold, uint32_t max_silence_ms) {
+    this->deadband_.enabled = true;
+    this->deadband_.axis_threshold = axis_threshold;
+    this->deadband_.vector_threshold = vector_threshold;
+    this->deadband_.max_silence_ms = max_silence_ms;
+  }
+#endif
+
+#if defined(USE_SENSOR) && defined(USE_LIS3DH_INCLINOMETER)
+  SUB_SENSOR(pitch)
+  SUB_SENSOR(roll)
+  SUB_SENSOR(tilt)
+  /// Publish the angles only when one moves by more than angle_threshold degrees (0 = any change),
+  /// or max_silence_ms has passed since the last publish (0 = never)
+  void set_inclinometer_deadband(float angle_threshold, uint32_t max_silence_ms) {
+    this->inclination_.threshold_cdeg = static_cast<int32_t>(lroundf(angle_threshold * 100.0f));
+    this->inclination_.max_silence_ms = max_silence_ms;
+  }
+#endif
+
+#if defined(USE_SENSOR) && defined(USE_LIS3DH_STATISTICS)
+  void set_statistics_sensor(SampleChannel channel, StatsKind kind, sensor::Sensor *sensor) {
+    this->statistics_sensors_[static_cast<uint8_t>(channel)][static_cast<uint8_t>(kind)] = sensor;
+  }
+#endif
+
+#if defined(USE_SENSOR) && defined(USE_LIS3DH_SPECTRUM)
+  void set_spectrum_block_size(uint16_t block_size) {
+    this->spectrum_enabled_ = true;
+    this->spectrum_.set_block_size(block_size);
+  }
+  void set_spectrum_channel(SampleChannel channel) { this->spectrum_channel_ = channel; }
+  void set_spectrum_time_budget(uint32_t time_budget_us) { this->spectrum_.set_time_budget(time_budget_us); }
+  void set_dominant_frequency_sensor(sensor::Sensor *sensor) { this->spectrum_.set_dominant_frequency_sensor(sensor); }
+  void add_spectrum_band(float min_frequency, float max_frequency, sensor::Sensor *sensor) {
+    this->spectrum_.add_band(min_frequency, max_frequency, sensor);
+  }
+#endif
+
+#if defined(USE_BINARY_SENSOR) && defined(USE_LIS3DH_GOERTZEL)
+  void add_goertzel_binary_sensor(GoertzelBinarySensor *sensor) { this->goertzel_sensors_.push_back(sensor); }
+#endif
+
 #ifdef USE_TEXT_SENSOR
   SUB_TEXT_SENSOR(orientation_xy)
   SUB_TEXT_SENSOR(orientation_z)
 #endif
 
-  Trigger<> *get_tap_trigger() { return &this->tap_trigger_; }
-  Trigger<> *get_double_tap_trigger() { return &this->double_tap_trigger_; }
-  Trigger<> *get_freefall_trigger() { return &this->freefall_trigger_; }
-  Trigger<> *get_orientation_trigger() { return &this->orientation_trigger_; }
+#ifdef USE_LIS3DH_PEDOMETER
+  void enable_pedometer() { this->pedometer_.enabled = true; }
+#ifdef USE_SENSOR
+  SUB_SENSOR(step_count)
+#endif
+#ifdef USE_TEXT_SENSOR
+  SUB_TEXT_SENSOR(activity)
+#endif
+#endif
+
+#ifdef USE_LIS3DH_CLICK_DETECTION
+  void enable_click_detection() { this->detectors_.click = true; }
+  Trigger<Event> *get_tap_trigger() { return &this->tap_trigger_; }
+  Trigger<Event> *get_double_tap_trigger() { return &this->double_tap_trigger_; }
+#endif
+#ifdef USE_LIS3DH_FREEFALL_DETECTION
+  void enable_freefall_detection() { this->detectors_.freefall = true; }
+  Trigger<Event> *get_freefall_trigger() { return &this->freefall_trigger_; }
+#endif
+#ifdef USE_LIS3DH_ORIENTATION_DETECTION
+  void enable_orientation_detection() { this->detectors_.orientation = true; }
+  Trigger<Event> *get_orientation_trigger() { return &this->orientation_trigger_; }
+#endif
 
  protected:
   Range range_{Range::RANGE_2G};
   DataRate data_rate_{DataRate::ODR_100HZ};
   Resolution resolution_{Resolution::RES_HIGH_RES};
+  /// FIFO watermark in frames; 0 disables the FIFO and reads the output registers directly
+  uint8_t fifo_watermark_{0};
+
+  /// Sleep-to-wake: after this long below the threshold (m/s²) the chip drops to 10 Hz low-power
+  /// and raises INT2 until motion returns. A duration of 0 disables it.
+  float inactivity_threshold_{0.0f};
+  uint32_t inactivity_duration_ms_{0};
+
+  /// Gravity removal in the chip. Freefall (IA1) and 6D (IA2) measure gravity itself, so they are never
+  /// filtered; with `output` the acceleration sensors and everything downstream see dynamic acceleration only.
+  struct {
+    uint8_t cutoff{0};
+    bool output{false};
+    bool click{false};
+  } high_pass_{};
+
+  /// Chip detectors this instance uses. The others stay disabled in the chip and their source
+  /// registers are never read; which ones exist at all is decided by codegen defines.
+  struct {
+    bool click{false};
+    bool freefall{false};
+    bool orientation{false};
+  } detectors_{};
+
+  /// Optional INT1 (click + freefall) and INT2 (6D orientation) pins; without them sources are polled every loop
+  InternalGPIOPin *interrupt1_pin_{nullptr};
+  InternalGPIOPin *interrupt2_pin_{nullptr};
+  InterruptPinStore interrupt1_store_{};
+  InterruptPinStore interrupt2_store_{};
 
   /// Sensitivity in g per digit (after right-shifting raw 16-bit value by 4)
   float sensitivity_{0.001f};
+  /// m/s² per LSB of the Q-format filter state; only applied when publishing
+  float scale_{0.0f};
 
+  /// Per-instance stage settings; stages this instance doesn't use stay at their identity value
   struct {
-    float x{0};
-    float y{0};
-    float z{0};
+    uint8_t median_window{1};
+    uint8_t moving_average_window{1};
+    float ema_alpha{1.0f};
+    BiquadType biquad_type{BiquadType::LOW_PASS};
+    float biquad_cutoff{0.0f};
+    float biquad_q{0.0f};
+  } filter_config_{};
+
+  /// One filter chain per axis (X, Y, Z)
+  AxisFilterChain filters_[3]{};
+
+  /// What the chip should contain; built once in setup() and reapplied if the chip resets
+  RegisterImage register_image_{};
+
+  /// Filtered acceleration in Q-format digits (SAMPLE_FRACTION_BITS fractional bits)
+  struct {
+    int32_t x{0};
+    int32_t y{0};
+    int32_t z{0};
   } data_{};
 
+  /// Shared with every other instance on the same bus; set in setup()
+  BusScheduler *scheduler_{nullptr};
+  uint32_t bus_time_budget_us_{2000};
+  uint32_t bus_time_us_{0};
+  /// Busy time and wall time at the last bus_utilization publish
+  uint32_t last_busy_us_{0};
+  uint32_t last_utilization_us_{0};
+
+  /// Above 400 Hz the FIFO outruns the normal loop() cadence
+  HighFrequencyLoopRequester high_freq_;
+
+  /// Set from loop() to make the next acquisition pass read regardless of the schedule
+  std::atomic<bool> read_now_{false};
+  std::atomic<bool> bus_error_{false};
+
+  /// Frames decoded by the latest bus read; filled on the acquisition side
+  SampleBlock<FIFO_DEPTH> block_{};
+
+#ifdef USE_LIS3DH_ACQUISITION_TASK
+  SpscRing<RawFrame, FRAME_RING_SIZE> frames_{};
+  /// Source reads submitted by loop() and completed by the task. A bit moves from `requested`
+  /// (set by loop()) to `completed` (set by the task once values/read_us hold the register), and
+  /// loop() clears it when it decodes the value on a later pass.
+  struct {
+    std::atomic<uint8_t> requested{0};
+    std::atomic<uint8_t> completed{0};
+    uint8_t values[SOURCE_COUNT]{};
+    uint32_t read_us[SOURCE_COUNT]{};
+  } source_reads_;
+  /// Register image check submitted by update() and run by the task, which also reapplies the
+  /// image; loop() reports the outcome. `result` and `found_ctrl1` are valid while `completed` is set.
+  struct {
+    std::atomic<bool> requested{false};
+    std::atomic<bool> completed{false};
+    ImageCheck result{ImageCheck::READ_FAILED};
+    uint8_t found_ctrl1{0};
+  } image_check_;
+  /// Frames popped from the ring in loop(), processed in batches of up to FIFO_DEPTH
+  SampleBlock<FIFO_DEPTH> drain_block_{};
+  uint8_t task_core_{1};
+  uint8_t task_priority_{5};
+#endif
+
+  /// Bus reads are paced to the output data rate instead of the main loop frequency
+  struct {
+    uint32_t sample_period_us{0};
+    uint32_t read_interval_us{0};
+    uint32_t last_read_us{0};
+    /// micros() when the newest sample was read; events are placed on the sample grid from here
+    std::atomic<uint32_t> last_sample_us{0};
+    /// Frames taken off the chip, and frames run through the pipeline (these differ with the task)
+    uint32_t frames_read{0};
+    uint32_t samples_read{0};
+    /// Samples the chip overwrote before they were read, estimated from the time between reads.
+    /// Counted where the data is read, which may be the acquisition task
+    std::atomic<uint32_t> samples_lost{0};
+  } acquisition_{};
+
+#if defined(USE_SENSOR) && defined(USE_LIS3DH_DEADBAND)
+  /// Acceleration is only published once it has moved past a threshold or the heartbeat runs out.
+  /// Thresholds are converted to Q-format digits in setup() so the check is pure integer math.
+  /// The define is global, so `enabled` marks the instances that configured a deadband.
+  struct {
+    bool enabled{false};
+    float axis_threshold{0.0f};
+    float vector_threshold{0.0f};
+    uint32_t max_silence_ms{0};
+    int32_t axis_threshold_q{0};
+    int64_t vector_threshold_sq{0};
+    int32_t last_x{0};
+    int32_t last_y{0};
+    int32_t last_z{0};
+    uint32_t last_publish_ms{0};
+    bool published{false};
+    uint32_t suppressed{0};
+  } deadband_{};
+  bool deadband_exceeded_();
+#endif
+
+#if defined(USE_SENSOR) && defined(USE_LIS3DH_INCLINOMETER)
+  /// Pitch, roll and tilt of the filtered data in centidegrees, refreshed after every filter pass
+  struct {
+    int32_t pitch{0};
+    int32_t roll{0};
+    int32_t tilt{0};
+    int32_t threshold_cdeg{0};
+    uint32_t max_silence_ms{0};
+    int32_t last_pitch{0};
+    int32_t last_roll{0};
+    int32_t last_tilt{0};
+    uint32_t last_publish_ms{0};
+    bool published{false};
+  } inclination_{};
+  void update_inclination_();
+  void publish_inclination_();
+#endif
+
+#if defined(USE_SENSOR) && defined(USE_LIS3DH_STATISTICS)
+  /// Unfiltered per-interval statistics for X, Y, Z and vector magnitude, reset after each publish
+  WindowStats statistics_[SAMPLE_CHANNEL_COUNT]{};
+  sensor::Sensor *statistics_sensors_[SAMPLE_CHANNEL_COUNT][STATS_KIND_COUNT]{};
+  void publish_statistics_();
+#endif
+
+#if defined(USE_SENSOR) && defined(USE_LIS3DH_MOTION_MAGNITUDE)
+  /// Vector magnitude of the high-pass filtered output over the update interval; published as its RMS
+  WindowStats motion_{};
+#endif
+
+#if defined(USE_SENSOR) && defined(USE_LIS3DH_SPECTRUM)
+  SpectrumAnalyzer spectrum_{};
+  SampleChannel spectrum_channel_{SampleChannel::MAGNITUDE};
+  bool spectrum_enabled_{false};
+#endif
+
+#if defined(USE_BINARY_SENSOR) && defined(USE_LIS3DH_GOERTZEL)
+  std::vector<GoertzelBinarySensor *> goertzel_sensors_;
+#endif
+
+#ifdef USE_LIS3DH_PEDOMETER
+  /// Fed every raw magnitude sample; the step count and activity are published from update() when they change
+  struct {
+    StepDetector detector{};
+    bool enabled{false};
+    bool published{false};
+    uint32_t last_steps{0};
+    Activity last_activity{Activity::STILL};
+  } pedometer_{};
+  void publish_pedometer_();
+#endif
+
   struct {
-    uint32_t last_tap_ms{0};
-    uint32_t last_double_tap_ms{0};
-    uint32_t last_freefall_ms{0};
-    uint32_t last_orientation_ms{0};
+    uint32_t last_freefall_sample{0};
+    bool freefall_seen{false};
+    uint8_t orientation_position{0};
     OrientationXY orientation_xy{OrientationXY::PORTRAIT_UPRIGHT};
     bool orientation_z{false};
     bool never_published{true};
+    std::atomic<bool> sleeping{false};
+    /// Counted where the data is read, which may be the acquisition task
+    std::atomic<uint32_t> data_overruns{0};
+    std::atomic<uint32_t> fifo_overruns{0};
+    uint32_t chip_resets{0};
+    /// Failed bus transactions; counted from loop() and the acquisition task
+    std::atomic<uint32_t> bus_errors{0};
   } status_{};
 
-  bool configure_ctrl_regs_();
-  bool configure_click_detection_();
-  bool configure_freefall_detection_();
-  bool configure_orientation_detection_();
+  void configure_ctrl_regs_(RegisterImage &image);
+  bool configure_fifo_();
+  void configure_filters_();
+  void configure_inactivity_(RegisterImage &image);
+  void configure_interrupt_pins_();
+#ifdef USE_LIS3DH_CLICK_DETECTION
+  void configure_click_detection_(RegisterImage &image);
+#endif
+#ifdef USE_LIS3DH_FREEFALL_DETECTION
+  void configure_freefall_detection_(RegisterImage &image);
+#endif
+#ifdef USE_LIS3DH_ORIENTATION_DETECTION
+  void configure_orientation_detection_(RegisterImage &image);
+#endif
+  /// Whether anything on this instance consumes the sample stream (sensors, statistics, DSP)
+  bool has_sample_consumer_() const;
+  bool write_register_image_();
+  bool verify_register_image_();
+  /// Compares CTRL_REG1..6 with the image and reapplies the image if the chip lost it
+  ImageCheck repair_register_image_(uint8_t *found_ctrl1);
+  void report_register_image_(ImageCheck check, uint8_t found_ctrl1);
+  /// Runs the check in place, or submits it to the acquisition task
+  void check_register_image_();
+
+  /// Transport: raw register access on the instance's bus
+  virtual bool bus_read_(RegisterMap reg, uint8_t *data, size_t len) = 0;
+  virtual bool bus_write_(RegisterMap reg, const uint8_t *data, size_t len) = 0;
+  /// Bus identity, so instances on the same bus share a scheduler
+  virtual const void *get_bus_() const = 0;
+
+  friend class BusScheduler;
+  /// Reads whatever is due on this instance; called by the bus scheduler
+  void service_bus_();
+  /// Sample reads, on the acquisition task when it is enabled
+  bool acquire_();
+  /// Sources to read when INTx fires (`line` 1 or 2), as a mask of EventSource bits
+  uint8_t line_sources_(uint8_t line) const;
+  void handle_source_(uint8_t source, uint8_t raw, uint32_t read_us);
+  /// INT2 after its sources have been read: sleep state, or re-arm
+  void finish_line2_();
+#ifdef USE_LIS3DH_ACQUISITION_TASK
+  /// loop() side: decode source reads the task completed, submit new ones for lines that fired
+  void collect_sources_();
+  /// Task side: perform the submitted source reads
+  void serve_source_reads_();
+  void collect_image_check_();
+  void serve_image_check_();
+#else
+  /// Synchronous fallback: read and decode the sources of lines that fired, in the scheduler's pass
+  void poll_sources_();
+  void read_sources_(uint8_t sources);
+#endif
+  /// Hands block_ to the pipeline, or to the ring when the acquisition task is running
+  void handle_block_();
+
+  bool read_registers_(RegisterMap reg, uint8_t *data, size_t len);
+  bool write_registers_(RegisterMap reg, const uint8_t *data, size_t len);
+  bool read_register_(RegisterMap reg, uint8_t *value) { return this->read_registers_(reg, value, 1); }
+  bool write_register_(RegisterMap reg, uint8_t value) { return this->write_registers_(reg, &value, 1); }
+
+  /// Output data rate in Hz for the configured rate and resolution (0 when powered down)
+  float get_output_data_rate_() const;
+  /// Overwritten on the chip plus dropped between the acquisition task and loop()
+  uint32_t get_samples_lost_() const;
 
   bool read_data_();
-  void poll_click_source_();
-  void poll_int1_source_();
-  void poll_int2_source_();
-
-  Trigger<> tap_trigger_;
-  Trigger<> double_tap_trigger_;
-  Trigger<> freefall_trigger_;
-  Trigger<> orientation_trigger_;
+  bool read_fifo_();
+  void process_block_(SampleBlock<FIFO_DEPTH> &block);
+#ifdef USE_LIS3DH_CLICK_DETECTION
+  void handle_click_source_(uint8_t raw, uint32_t read_us);
+#endif
+#ifdef USE_LIS3DH_FREEFALL_DETECTION
+  void handle_int1_source_(uint8_t raw, uint32_t read_us);
+#endif
+#ifdef USE_LIS3DH_ORIENTATION_DETECTION
+  void handle_int2_source_(uint8_t raw, uint32_t read_us);
+#endif
+  bool interrupt_pending_(InternalGPIOPin *pin, InterruptPinStore &store);
+  void rearm_interrupt_(InternalGPIOPin *pin, InterruptPinStore &store);
+  void update_sleep_state_();
+  Event make_event_(EventType type, EventAxis axis, bool negative, uint32_t read_us);
+  void dispatch_events_();
+#if defined(USE_TEXT_SENSOR) && defined(USE_LIS3DH_ORIENTATION_DETECTION)
+  void seed_orientation_();
+  void publish_orientation_xy_(OrientationXY orientation);
+  void publish_orientation_z_(bool downwards);
+#endif
+
+  /// Events wait here between the source-register polls and the triggers
+  EventQueue<16> events_{};
+#ifdef USE_LIS3DH_CLICK_DETECTION
+  Trigger<Event> tap_trigger_;
+  Trigger<Event> double_tap_trigger_;
+#endif
+#ifdef USE_LIS3DH_FREEFALL_DETECTION
+  Trigger<Event> freefall_trigger_;
+#endif
+#ifdef USE_LIS3DH_ORIENTATION_DETECTION
+  Trigger<Event> orientation_trigger_;
+#endif
 };
 
 }  // namespace lis3dh
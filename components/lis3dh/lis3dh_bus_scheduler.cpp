@@ -0,0 +1,116 @@
+#include "lis3dh_bus_scheduler.h"
+#include "lis3dh.h"
+#include "esphome/core/hal.h"
+
+#include <algorithm>
+
+#ifdef USE_LIS3DH_BENCHMARK
+#include "lis3dh_sim_component.h"
+#endif
+
+#ifdef USE_LIS3DH_ACQUISITION_TASK
+#ifdef USE_ESP32
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#else
+#include <thread>
+#endif
+#endif
+
+namespace esphome {
+namespace lis3dh {
+
+size_t BusScheduler::attached_ = 0;
+
+std::vector<BusScheduler *> &BusScheduler::schedulers_() {
+  // A handful of buses at most, allocated once during setup and never freed
+  static std::vector<BusScheduler *> schedulers;
+  return schedulers;
+}
+
+BusScheduler *BusScheduler::attach(const void *bus, LIS3DHComponent *device, uint32_t time_budget_us) {
+  auto &schedulers = schedulers_();
+  auto it = std::find_if(schedulers.begin(), schedulers.end(),
+                         [bus](BusScheduler *scheduler) { return scheduler->bus_ == bus; });
+  BusScheduler *scheduler;
+  if (it == schedulers.end()) {
+    scheduler = new BusScheduler(bus);  // NOLINT(cppcoreguidelines-owning-memory)
+    schedulers.push_back(scheduler);
+  } else {
+    scheduler = *it;
+  }
+  scheduler->devices_.push_back(device);
+  attached_++;
+  // Any instance may ask for more time; the bus gets the largest request
+  scheduler->time_budget_us_ = std::max(scheduler->time_budget_us_, time_budget_us);
+  return scheduler;
+}
+
+bool BusScheduler::is_owner(const LIS3DHComponent *device) const {
+  for (auto *candidate : this->devices_) {
+    if (!candidate->is_failed())
+      return candidate == device;
+  }
+  return false;
+}
+
+void BusScheduler::run() {
+  uint32_t start = micros();
+  size_t count = this->devices_.size();
+  bool serviced = false;
+  for (size_t i = 0; i < count; i++) {
+    if (serviced && micros() - start >= this->time_budget_us_) {
+      break;
+    }
+    LIS3DHComponent *device = this->devices_[this->next_];
+    this->next_ = (this->next_ + 1) % count;
+    // Still being set up, or gave up
+    if (!device->is_ready()) {
+      continue;
+    }
+    device->service_bus_();
+    serviced = true;
+  }
+}
+
+uint32_t BusScheduler::get_busy_us() const {
+  uint32_t busy = 0;
+  for (auto *device : this->devices_) {
+    busy += device->get_bus_time_us();
+  }
+  return busy;
+}
+
+#ifdef USE_LIS3DH_ACQUISITION_TASK
+void BusScheduler::start_task([[maybe_unused]] uint8_t core, [[maybe_unused]] uint8_t priority) {
+  static bool started = false;
+  if (started || attached_ < LIS3DH_INSTANCE_COUNT) {
+    return;
+  }
+  started = true;
+#ifdef USE_ESP32
+  // Single-core chips only have core 0
+  xTaskCreatePinnedToCore(task_main_, "lis3dh", 4096, nullptr, priority, nullptr,
+                          core < portNUM_PROCESSORS ? core : 0);
+#else
+  std::thread(task_main_, nullptr).detach();
+#endif
+}
+
+void BusScheduler::task_main_(void * /*arg*/) {
+#ifdef USE_LIS3DH_BENCHMARK
+  // Everything on this task is driver work
+  in_driver = true;
+#endif
+  while (true) {
+    for (auto *scheduler : schedulers_()) {
+      scheduler->run();
+    }
+    // Reads are paced by each instance's schedule; this only bounds how late one can start
+    delay(1);
+  }
+}
+#endif
+
+}  // namespace lis3dh
+}  // namespace esphome
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "esphome/core/defines.h"
+#include "esphome/core/helpers.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace esphome {
+namespace lis3dh {
+
+class LIS3DHComponent;
+
+/// Shares one bus between every LIS3DH on it. The first instance set up on a bus owns the
+/// scheduler and, from its loop(), services the instances round-robin until the per-pass time
+/// budget is used up; the next pass resumes with whichever instance was skipped. At least one
+/// instance is serviced per pass, so a single slow read can exceed the budget but never starve.
+class BusScheduler {
+ public:
+  /// Scheduler for `bus`, created on first use; registers `device` with it
+  static BusScheduler *attach(const void *bus, LIS3DHComponent *device, uint32_t time_budget_us);
+
+  /// The first instance that hasn't failed drives the bus (a failed component's loop() never runs)
+  bool is_owner(const LIS3DHComponent *device) const;
+  size_t size() const { return this->devices_.size(); }
+  uint32_t get_time_budget() const { return this->time_budget_us_; }
+
+  /// One pass over the bus, called by the owner's loop()
+  void run();
+
+  /// Microseconds all LIS3DH instances spent in bus transactions, wrapping; their share of bus time
+  /// is the difference between two readings divided by the wall time between them. Transactions of
+  /// other devices on the same bus aren't counted.
+  uint32_t get_busy_us() const;
+
+#ifdef USE_LIS3DH_ACQUISITION_TASK
+  /// Serialises transactions between the acquisition task and loop()
+  Mutex &get_lock() { return this->lock_; }
+
+  /// Starts the one acquisition task that runs every bus's scheduler. Nothing happens until all
+  /// LIS3DH_INSTANCE_COUNT instances have attached: later components are still being set up while
+  /// earlier ones loop, and the task walks the same vectors attach() grows. Once it runs they are
+  /// never touched again. Later calls do nothing.
+  static void start_task(uint8_t core, uint8_t priority);
+#endif
+
+ protected:
+  explicit BusScheduler(const void *bus) : bus_(bus) {}
+  static std::vector<BusScheduler *> &schedulers_();
+  /// Instances attached to any bus so far
+  static size_t attached_;
+#ifdef USE_LIS3DH_ACQUISITION_TASK
+  static void task_main_(void *arg);
+
+  Mutex lock_;
+#endif
+
+  const void *bus_;
+  std::vector<LIS3DHComponent *> devices_;
+  uint32_t time_budget_us_{0};
+  uint8_t next_{0};
+};
+
+}  // namespace lis3dh
+}  // namespace esphome
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+
+namespace esphome {
+namespace lis3dh {
+
+enum class EventType : uint8_t {
+  TAP = 0,
+  DOUBLE_TAP = 1,
+  FREEFALL = 2,
+  ORIENTATION = 3,
+};
+
+enum class EventAxis : uint8_t {
+  NONE = 0,
+  X = 1,
+  Y = 2,
+  Z = 3,
+};
+
+/// One hardware event as passed to the on_* automations (`event` in lambdas)
+struct Event {
+  EventType type;
+  /// Click axis for taps, the axis pointing along gravity for orientation, NONE for freefall
+  EventAxis axis;
+  /// Click sign for taps, the low (negative) side of the axis for orientation
+  bool negative;
+  /// Index of the output sample the event was latched on, counted since setup
+  uint32_t sample_index;
+  /// millis() at that sample, reconstructed from the sample grid rather than from when it was read
+  uint32_t timestamp_ms;
+};
+
+/// Fixed-capacity FIFO of events between the source-register polls and the triggers.
+/// When full the newest event is dropped and counted, so a burst never blocks the poll.
+template<uint8_t N> class EventQueue {
+ public:
+  bool push(const Event &event) {
+    if (this->size_ == N) {
+      this->overflows_++;
+      return false;
+    }
+    this->events_[(this->head_ + this->size_) % N] = event;
+    this->size_++;
+    return true;
+  }
+
+  bool pop(Event &event) {
+    if (this->size_ == 0)
+      return false;
+    event = this->events_[this->head_];
+    this->head_ = (this->head_ + 1) % N;
+    this->size_--;
+    return true;
+  }
+
+  uint32_t get_overflows() const { return this->overflows_; }
+
+ protected:
+  Event events_[N]{};
+  uint8_t head_{0};
+  uint8_t size_{0};
+  uint32_t overflows_{0};
+};
+
+}  // namespace lis3dh
+}  // namespace esphome
@@ -0,0 +1,203 @@
+#pragma once
+
+#include "esphome/core/defines.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+namespace lis3dh {
+
+// ---- Per-axis DSP stages ----
+//
+// All stages work on the Q-format integer samples produced by the component (raw digits
+// << SAMPLE_FRACTION_BITS), so nothing here touches floating point per sample. Which
+// stages exist is decided at compile time by codegen defines; a stage that is not
+// configured collapses to PassThroughFilter, which the compiler removes entirely.
+
+/// Stand-in for a stage that is compiled out
+struct PassThroughFilter {
+  int32_t apply(int32_t value) { return value; }
+};
+
+/// Median of the last `window` samples (window <= N), rejects single-sample spikes
+template<uint8_t N> class MedianFilter {
+ public:
+  void set_window(uint8_t window) { this->window_ = std::max<uint8_t>(1, std::min(window, N)); }
+
+  int32_t apply(int32_t value) {
+    if (!this->primed_) {
+      std::fill(this->history_, this->history_ + N, value);
+      this->primed_ = true;
+    }
+    this->history_[this->index_] = value;
+    this->index_ = (this->index_ + 1) % this->window_;
+
+    // Insertion sort of at most N values is cheaper than anything cleverer at these sizes
+    int32_t sorted[N];
+    for (uint8_t i = 0; i < this->window_; i++) {
+      int32_t v = this->history_[i];
+      uint8_t j = i;
+      for (; j > 0 && sorted[j - 1] > v; j--)
+        sorted[j] = sorted[j - 1];
+      sorted[j] = v;
+    }
+    return sorted[this->window_ / 2];
+  }
+
+ protected:
+  int32_t history_[N]{};
+  uint8_t window_{N};
+  uint8_t index_{0};
+  bool primed_{false};
+};
+
+/// Boxcar average of the last `window` samples (window <= N) using a running sum
+template<uint8_t N> class MovingAverageFilter {
+ public:
+  void set_window(uint8_t window) { this->window_ = std::max<uint8_t>(1, std::min(window, N)); }
+
+  int32_t apply(int32_t value) {
+    if (!this->primed_) {
+      std::fill(this->history_, this->history_ + N, value);
+      this->sum_ = value * this->window_;
+      this->primed_ = true;
+    }
+    this->sum_ += value - this->history_[this->index_];
+    this->history_[this->index_] = value;
+    this->index_ = (this->index_ + 1) % this->window_;
+    return this->sum_ / this->window_;
+  }
+
+ protected:
+  int32_t history_[N]{};
+  int32_t sum_{0};
+  uint8_t window_{N};
+  uint8_t index_{0};
+  bool primed_{false};
+};
+
+/// Single-pole exponential moving average, y += α·(x − y) with α in Q15
+class EmaFilter {
+ public:
+  void set_alpha(float alpha) { this->alpha_q15_ = static_cast<int32_t>(lroundf(alpha * (1 << 15))); }
+
+  int32_t apply(int32_t value) {
+    this->state_ += static_cast<int32_t>((static_cast<int64_t>(value - this->state_) * this->alpha_q15_) >> 15);
+    return this->state_;
+  }
+
+ protected:
+  int32_t alpha_q15_{1 << 15};
+  int32_t state_{0};
+};
+
+enum class BiquadType : uint8_t {
+  LOW_PASS = 0,
+  HIGH_PASS = 1,
+};
+
+/// Second-order IIR section (RBJ cookbook), direct form I with Q28 coefficients and 64-bit accumulation
+class BiquadFilter {
+ public:
+  void configure(BiquadType type, float cutoff, float q, float sample_rate) {
+    float w0 = 2.0f * static_cast<float>(M_PI) * cutoff / sample_rate;
+    float cos_w0 = cosf(w0);
+    float alpha = sinf(w0) / (2.0f * q);
+    float a0 = 1.0f + alpha;
+    float b0, b1;
+    if (type == BiquadType::LOW_PASS) {
+      b0 = (1.0f - cos_w0) / 2.0f;
+      b1 = 1.0f - cos_w0;
+    } else {
+      b0 = (1.0f + cos_w0) / 2.0f;
+      b1 = -(1.0f + cos_w0);
+    }
+    this->b0_ = to_q28_(b0 / a0);
+    this->b1_ = to_q28_(b1 / a0);
+    this->b2_ = this->b0_;
+    this->a1_ = to_q28_(-2.0f * cos_w0 / a0);
+    this->a2_ = to_q28_((1.0f - alpha) / a0);
+    // Unity DC gain for low-pass, zero for high-pass; used to start in steady state
+    this->dc_gain_ = type == BiquadType::LOW_PASS;
+  }
+
+  int32_t apply(int32_t value) {
+    if (!this->primed_) {
+      this->x1_ = this->x2_ = value;
+      this->y1_ = this->y2_ = this->dc_gain_ ? value : 0;
+      this->primed_ = true;
+    }
+    int64_t acc = static_cast<int64_t>(this->b0_) * value + static_cast<int64_t>(this->b1_) * this->x1_ +
+                  static_cast<int64_t>(this->b2_) * this->x2_ - static_cast<int64_t>(this->a1_) * this->y1_ -
+                  static_cast<int64_t>(this->a2_) * this->y2_;
+    int32_t out = static_cast<int32_t>(acc >> 28);
+    this->x2_ = this->x1_;
+    this->x1_ = value;
+    this->y2_ = this->y1_;
+    this->y1_ = out;
+    return out;
+  }
+
+ protected:
+  static int32_t to_q28_(float coefficient) { return static_cast<int32_t>(lroundf(coefficient * (1 << 28))); }
+
+  // Defaults to an identity section
+  int32_t b0_{1 << 28}, b1_{0}, b2_{0}, a1_{0}, a2_{0};
+  int32_t x1_{0}, x2_{0}, y1_{0}, y2_{0};
+  bool dc_gain_{true};
+  bool primed_{false};
+};
+
+/// Fixed-order chain: median (spike rejection) → moving average → EMA → biquad
+template<typename Median, typename MovingAverage, typename Ema, typename Biquad> struct FilterChain {
+  Median median;
+  MovingAverage moving_average;
+  Ema ema;
+  Biquad biquad;
+
+  int32_t apply(int32_t value) {
+    return this->biquad.apply(this->ema.apply(this->moving_average.apply(this->median.apply(value))));
+  }
+
+  /// Runs `count` raw samples through the chain, shifting each into Q-format first; returns the
+  /// last output. The stages are recursive, so this is a tight serial loop with the filter state
+  /// kept in registers rather than one out-of-line call per sample.
+  int32_t apply_block(const int16_t *samples, size_t count, uint8_t fraction_bits) {
+    int32_t out = 0;
+    for (size_t i = 0; i < count; i++)
+      out = this->apply(static_cast<int32_t>(samples[i]) << fraction_bits);
+    return out;
+  }
+};
+
+#ifdef USE_LIS3DH_MEDIAN_FILTER
+using MedianStage = MedianFilter<LIS3DH_MEDIAN_FILTER_SIZE>;
+#else
+using MedianStage = PassThroughFilter;
+#endif
+
+#ifdef USE_LIS3DH_MOVING_AVERAGE_FILTER
+using MovingAverageStage = MovingAverageFilter<LIS3DH_MOVING_AVERAGE_FILTER_SIZE>;
+#else
+using MovingAverageStage = PassThroughFilter;
+#endif
+
+#ifdef USE_LIS3DH_EMA_FILTER
+using EmaStage = EmaFilter;
+#else
+using EmaStage = PassThroughFilter;
+#endif
+
+#ifdef USE_LIS3DH_BIQUAD_FILTER
+using BiquadStage = BiquadFilter;
+#else
+using BiquadStage = PassThroughFilter;
+#endif
+
+using AxisFilterChain = FilterChain<MedianStage, MovingAverageStage, EmaStage, BiquadStage>;
+
+}  // namespace lis3dh
+}  // namespace esphome
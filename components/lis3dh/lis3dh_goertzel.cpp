@@ -0,0 +1,63 @@
+#include "lis3dh_goertzel.h"
+
+#ifdef USE_LIS3DH_GOERTZEL
+
+#include "esphome/core/log.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace esphome {
+namespace lis3dh {
+
+static const char *const TAG = "lis3dh.binary_sensor";
+
+void GoertzelBinarySensor::setup(float sample_rate, float digit_scale) {
+  this->digit_scale_ = digit_scale;
+  if (this->frequency_ >= sample_rate / 2.0f) {
+    ESP_LOGW(TAG, "Target frequency %.1f Hz is above the Nyquist frequency of %.1f Hz", this->frequency_,
+             sample_rate / 2.0f);
+  }
+  float omega = 2.0f * static_cast<float>(M_PI) * this->frequency_ / sample_rate;
+  this->coeff_q14_ = static_cast<int32_t>(lroundf(2.0f * cosf(omega) * (1 << 14)));
+  this->publish_initial_state(false);
+}
+
+void GoertzelBinarySensor::dump_config() {
+  LOG_BINARY_SENSOR("  ", "Machine Running", this);
+  ESP_LOGCONFIG(TAG,
+                "    Frequency: %.2f Hz\n"
+                "    Block Size: %u samples\n"
+                "    Thresholds: on %.3f m/s², off %.3f m/s²",
+                this->frequency_, this->block_size_, this->on_threshold_, this->off_threshold_);
+}
+
+void GoertzelBinarySensor::evaluate_block_() {
+  // |X|² = s1² + s2² − coeff·s1·s2; the tone amplitude is 2·|X| / N
+  float s1 = this->s1_;
+  float s2 = this->s2_;
+  float power = s1 * s1 + s2 * s2 - (this->coeff_q14_ / 16384.0f) * s1 * s2;
+  this->amplitude_ = 2.0f * sqrtf(std::max(power, 0.0f)) / this->block_size_ * this->digit_scale_;
+
+  // The very first block has no DC estimate yet, so its result is meaningless
+  if (this->dc_valid_) {
+    ESP_LOGV(TAG, "Amplitude at %.1f Hz: %.4f m/s²", this->frequency_, this->amplitude_);
+    if (!this->state && this->amplitude_ >= this->on_threshold_) {
+      this->publish_state(true);
+    } else if (this->state && this->amplitude_ < this->off_threshold_) {
+      this->publish_state(false);
+    }
+  }
+
+  this->dc_ = this->sum_ / this->block_size_;
+  this->dc_valid_ = true;
+  this->sum_ = 0;
+  this->count_ = 0;
+  this->s1_ = 0;
+  this->s2_ = 0;
+}
+
+}  // namespace lis3dh
+}  // namespace esphome
+
+#endif  // USE_LIS3DH_GOERTZEL
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "esphome/core/defines.h"
+
+#ifdef USE_LIS3DH_GOERTZEL
+
+#include "esphome/components/binary_sensor/binary_sensor.h"
+
+#include "lis3dh_math.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+namespace lis3dh {
+
+/// Binary sensor that is on while one channel carries a tone at the target frequency ("machine running").
+/// A single Goertzel resonator runs on every sample in Q14 integer math (O(1), a few words of state);
+/// once per block the tone amplitude is compared against on/off thresholds with hysteresis.
+class GoertzelBinarySensor : public binary_sensor::BinarySensor {
+ public:
+  void set_frequency(float frequency) { this->frequency_ = frequency; }
+  void set_channel(SampleChannel channel) { this->channel_ = channel; }
+  void set_block_size(uint16_t block_size) { this->block_size_ = block_size; }
+  void set_on_threshold(float on_threshold) { this->on_threshold_ = on_threshold; }
+  void set_off_threshold(float off_threshold) { this->off_threshold_ = off_threshold; }
+
+  SampleChannel get_channel() const { return this->channel_; }
+
+  void setup(float sample_rate, float digit_scale);
+  void dump_config();
+
+  /// Feed one raw sample (digits) of the configured channel
+  void add_sample(int32_t value) {
+    // Remove the DC level (gravity) measured over the previous block, it would otherwise leak into the bin
+    int32_t x = value - this->dc_;
+    int32_t s0 = x + static_cast<int32_t>((static_cast<int64_t>(this->coeff_q14_) * this->s1_) >> 14) - this->s2_;
+    this->s2_ = this->s1_;
+    this->s1_ = s0;
+    this->sum_ += value;
+    if (++this->count_ == this->block_size_) {
+      this->evaluate_block_();
+    }
+  }
+
+  void add_samples(const int16_t *values, size_t count) {
+    for (size_t i = 0; i < count; i++)
+      this->add_sample(values[i]);
+  }
+
+ protected:
+  void evaluate_block_();
+
+  float frequency_{50.0f};
+  SampleChannel channel_{SampleChannel::MAGNITUDE};
+  uint16_t block_size_{200};
+  float on_threshold_{0.0f};
+  float off_threshold_{0.0f};
+
+  float digit_scale_{0.0f};
+  /// 2·cos(2π·f/fs) in Q14
+  int32_t coeff_q14_{0};
+  int32_t s1_{0};
+  int32_t s2_{0};
+  int32_t dc_{0};
+  int32_t sum_{0};
+  uint16_t count_{0};
+  bool dc_valid_{false};
+  float amplitude_{0.0f};
+};
+
+}  // namespace lis3dh
+}  // namespace esphome
+
+#endif  // USE_LIS3DH_GOERTZEL
@@ -0,0 +1,34 @@
+#include "lis3dh_i2c.h"
+
+#if defined(USE_I2C) || defined(USE_LIS3DH_SIMULATOR)
+
+#include "esphome/core/log.h"
+
+namespace esphome {
+namespace lis3dh {
+
+static const char *const TAG = "lis3dh.i2c";
+
+void LIS3DHI2CComponent::dump_config() {
+  LIS3DHComponent::dump_config();
+  LOG_I2C_DEVICE(this);
+}
+
+bool LIS3DHI2CComponent::bus_read_(RegisterMap reg, uint8_t *data, size_t len) {
+  uint8_t address = static_cast<uint8_t>(reg);
+  if (len > 1)
+    address |= I2C_AUTO_INCREMENT;
+  return this->read_register(address, data, len) == i2c::ERROR_OK;
+}
+
+bool LIS3DHI2CComponent::bus_write_(RegisterMap reg, const uint8_t *data, size_t len) {
+  uint8_t address = static_cast<uint8_t>(reg);
+  if (len > 1)
+    address |= I2C_AUTO_INCREMENT;
+  return this->write_register(address, data, len) == i2c::ERROR_OK;
+}
+
+}  // namespace lis3dh
+}  // namespace esphome
+
+#endif  // USE_I2C || USE_LIS3DH_SIMULATOR
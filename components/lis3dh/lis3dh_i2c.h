@@ -0,0 +1,30 @@
+#pragma once
+
+#include "esphome/core/defines.h"
+
+// The simulator runs this component on a stand-in bus, without an i2c: block
+#if defined(USE_I2C) || defined(USE_LIS3DH_SIMULATOR)
+
+#include "esphome/components/i2c/i2c.h"
+#include "lis3dh.h"
+
+namespace esphome {
+namespace lis3dh {
+
+/// Sub-address bit that makes the register pointer auto-increment across a burst
+static const uint8_t I2C_AUTO_INCREMENT = 0x80;
+
+class LIS3DHI2CComponent : public LIS3DHComponent, public i2c::I2CDevice {
+ public:
+  void dump_config() override;
+
+ protected:
+  bool bus_read_(RegisterMap reg, uint8_t *data, size_t len) override;
+  bool bus_write_(RegisterMap reg, const uint8_t *data, size_t len) override;
+  const void *get_bus_() const override { return this->bus_; }
+};
+
+}  // namespace lis3dh
+}  // namespace esphome
+
+#endif  // USE_I2C || USE_LIS3DH_SIMULATOR
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+namespace lis3dh {
+
+enum class Activity : uint8_t {
+  STILL = 0,
+  WALKING = 1,
+  RUNNING = 2,
+};
+
+/// Step counter and activity classifier on the raw vector magnitude, one sample at a time.
+///
+/// The magnitude is smoothed (~20 ms) and a slow (~1 s) baseline, i.e. gravity, is subtracted.
+/// A step is a swing above an adaptive threshold (half the average recent peak, never below a
+/// noise floor) that comes back through the baseline, at least 250 ms after the previous one.
+/// Steps only count once CONFIRM_STEPS of them arrived at most 2 s apart, so a single bump or a
+/// door closing doesn't; the confirming steps are then added at once.
+/// Activity follows from cadence and peak height and drops back to still after 2.5 s without a step.
+/// Integer math on a few words of state, no allocation.
+class StepDetector {
+ public:
+  static const uint8_t CONFIRM_STEPS = 4;
+
+  /// `digits_per_g` converts the g-based thresholds to the magnitude's raw digits
+  void setup(float sample_rate, float digits_per_g) {
+    auto shift_for = [sample_rate](float seconds) {
+      return static_cast<uint8_t>(std::max(0L, std::min(lroundf(log2f(std::max(sample_rate * seconds, 1.0f))), 12L)));
+    };
+    this->smooth_shift_ = shift_for(0.02f);
+    this->baseline_shift_ = shift_for(1.0f);
+    this->min_interval_ = static_cast<uint32_t>(sample_rate * 0.25f);
+    this->max_interval_ = static_cast<uint32_t>(sample_rate * 2.0f);
+    this->still_after_ = static_cast<uint32_t>(sample_rate * 2.5f);
+    // Cadence of 150 steps/min or more, or impacts past 1 g above gravity, is running
+    this->running_interval_ = static_cast<int32_t>(sample_rate * 0.4f);
+    this->running_peak_ = static_cast<int32_t>(digits_per_g * 1.0f);
+    this->min_threshold_ = static_cast<int32_t>(digits_per_g * 0.08f);
+  }
+
+  void add_sample(int32_t magnitude) {
+    this->sample_++;
+    // Q8 so the shifts don't throw away the low bits of slow changes
+    if (!this->primed_) {
+      this->smooth_q8_ = magnitude * 256;
+      this->baseline_q8_ = this->smooth_q8_;
+      this->primed_ = true;
+    }
+    this->smooth_q8_ += (magnitude * 256 - this->smooth_q8_) >> this->smooth_shift_;
+    this->baseline_q8_ += (this->smooth_q8_ - this->baseline_q8_) >> this->baseline_shift_;
+    int32_t swing = (this->smooth_q8_ - this->baseline_q8_) / 256;
+
+    if (!this->rising_) {
+      if (swing > std::max(this->min_threshold_, this->peak_average_ / 2)) {
+        this->rising_ = true;
+        this->peak_ = swing;
+      }
+    } else {
+      this->peak_ = std::max(this->peak_, swing);
+      if (swing < 0) {
+        this->rising_ = false;
+        this->on_step_(this->peak_);
+      }
+    }
+
+    if (this->streak_ > 0 && this->sample_ - this->last_step_ > this->still_after_) {
+      this->streak_ = 0;
+      this->peak_average_ = 0;
+      this->activity_ = Activity::STILL;
+    }
+  }
+
+  void add_samples(const int16_t *magnitudes, size_t count) {
+    for (size_t i = 0; i < count; i++)
+      this->add_sample(magnitudes[i]);
+  }
+
+  uint32_t get_steps() const { return this->steps_; }
+  Activity get_activity() const { return this->activity_; }
+
+ protected:
+  void on_step_(int32_t peak) {
+    uint32_t interval = this->sample_ - this->last_step_;
+    if (this->streak_ > 0 && interval < this->min_interval_) {
+      // Ringing after the same heel strike
+      return;
+    }
+    this->last_step_ = this->sample_;
+    this->peak_average_ += (peak - this->peak_average_) / 4;
+
+    if (this->streak_ == 0 || interval > this->max_interval_) {
+      // First step after a pause; wait for a rhythm before counting anything
+      this->streak_ = 1;
+      return;
+    }
+    this->interval_average_ = this->streak_ == 1 ? static_cast<int32_t>(interval)
+                                                 : this->interval_average_ +
+                                                       (static_cast<int32_t>(interval) - this->interval_average_) / 4;
+    if (this->streak_ < CONFIRM_STEPS) {
+      this->streak_++;
+      if (this->streak_ < CONFIRM_STEPS) {
+        return;
+      }
+      this->steps_ += CONFIRM_STEPS;
+    } else {
+      this->steps_++;
+    }
+    bool running = this->interval_average_ <= this->running_interval_ || this->peak_average_ >= this->running_peak_;
+    this->activity_ = running ? Activity::RUNNING : Activity::WALKING;
+  }
+
+  uint8_t smooth_shift_{1};
+  uint8_t baseline_shift_{7};
+  uint32_t min_interval_{25};
+  uint32_t max_interval_{200};
+  uint32_t still_after_{250};
+  int32_t running_interval_{40};
+  int32_t running_peak_{1000};
+  int32_t min_threshold_{80};
+
+  bool primed_{false};
+  int32_t smooth_q8_{0};
+  int32_t baseline_q8_{0};
+  bool rising_{false};
+  int32_t peak_{0};
+  int32_t peak_average_{0};
+  int32_t interval_average_{0};
+  uint32_t sample_{0};
+  uint32_t last_step_{0};
+  uint8_t streak_{0};
+  uint32_t steps_{0};
+  Activity activity_{Activity::STILL};
+};
+
+}  // namespace lis3dh
+}  // namespace esphome
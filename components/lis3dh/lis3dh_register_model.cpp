@@ -0,0 +1,551 @@
+#include "lis3dh_register_model.h"
+
+#ifdef USE_LIS3DH_SIMULATOR
+
+#include "esphome/core/hal.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace esphome {
+namespace lis3dh {
+
+/// Output data rate in Hz indexed by CTRL_REG1 ODR (normal/high-resolution, then low-power for the top setting)
+static const uint32_t SIM_DATA_RATE_HZ[] = {0, 1, 10, 25, 50, 100, 200, 400, 1600, 1344};
+static const uint32_t SIM_LOW_POWER_TOP_RATE_HZ = 5376;
+
+/// mg per 12-bit digit, per INTx_THS LSB and per CLICK_THS LSB, indexed by full scale
+static const float SIM_MG_PER_DIGIT[] = {1.0f, 2.0f, 4.0f, 12.0f};
+static const float SIM_INT_THS_MG[] = {16.0f, 32.0f, 62.0f, 186.0f};
+static const float SIM_CLICK_THS_MG[] = {16.0f, 32.0f, 62.0f, 125.0f};
+
+/// Longest stretch of samples generated in one go; a longer stall only advances the clock
+static const uint64_t SIM_MAX_CATCH_UP_S = 2;
+
+static const uint8_t SIM_AUTO_INCREMENT = 0x80;
+static const uint8_t SIM_WHO_AM_I = 0x33;
+
+void LIS3DHRegisterModel::power_on_reset() {
+  memset(this->registers_, 0, sizeof(this->registers_));
+  this->reg_(RegisterMap::WHO_AM_I) = SIM_WHO_AM_I;
+  this->reg_(RegisterMap::CTRL_REG1) = 0x07;
+  memset(this->output_, 0, sizeof(this->output_));
+  this->bdu_held_ = 0;
+  this->fifo_head_ = 0;
+  this->fifo_level_ = 0;
+  memset(this->high_pass_input_, 0, sizeof(this->high_pass_input_));
+  memset(this->high_pass_output_, 0, sizeof(this->high_pass_output_));
+  this->generators_[0] = {};
+  this->generators_[1] = {};
+  this->click_.state = ClickState::IDLE;
+  this->last_update_us_ = micros();
+  this->phase_ = 0;
+}
+
+void LIS3DHRegisterModel::set_waveform(uint8_t axis, float offset, float amplitude, float frequency) {
+  if (axis < 3) {
+    this->waveform_[axis] = {offset, amplitude, frequency};
+  }
+}
+
+bool LIS3DHRegisterModel::load_trace(const std::string &path) {
+  FILE *file = fopen(path.c_str(), "r");
+  if (file == nullptr) {
+    return false;
+  }
+  this->trace_.clear();
+  char line[128];
+  while (fgets(line, sizeof(line), file) != nullptr) {
+    std::array<float, 3> row;
+    if (sscanf(line, " %f , %f , %f", &row[0], &row[1], &row[2]) == 3) {
+      this->trace_.push_back(row);
+    }
+  }
+  fclose(file);
+  return !this->trace_.empty();
+}
+
+// ---- Bus access ----
+
+void LIS3DHRegisterModel::read(uint8_t sub_address, uint8_t *data, size_t len) {
+  if (this->power_cycle_pending_.exchange(false)) {
+    this->power_on_reset();
+  }
+  this->catch_up_();
+  bool increment = sub_address & SIM_AUTO_INCREMENT;
+  uint8_t reg = sub_address & ~SIM_AUTO_INCREMENT;
+  for (size_t i = 0; i < len; i++) {
+    data[i] = this->read_register_(reg);
+    if (!increment) {
+      continue;
+    }
+    // Reading the FIFO in one burst: the pointer goes back to OUT_X_L after each frame
+    if (reg == static_cast<uint8_t>(RegisterMap::OUT_Z_H) && this->fifo_active_()) {
+      reg = static_cast<uint8_t>(RegisterMap::OUT_X_L);
+    } else {
+      reg = (reg + 1) & ~SIM_AUTO_INCREMENT;
+    }
+  }
+}
+
+void LIS3DHRegisterModel::write(uint8_t sub_address, const uint8_t *data, size_t len) {
+  if (this->power_cycle_pending_.exchange(false)) {
+    this->power_on_reset();
+  }
+  this->catch_up_();
+  bool increment = sub_address & SIM_AUTO_INCREMENT;
+  uint8_t reg = sub_address & ~SIM_AUTO_INCREMENT;
+  for (size_t i = 0; i < len; i++) {
+    this->write_register_(reg, data[i]);
+    if (increment) {
+      reg = (reg + 1) & ~SIM_AUTO_INCREMENT;
+    }
+  }
+}
+
+uint8_t LIS3DHRegisterModel::read_register_(uint8_t reg) {
+  if (reg >= sizeof(this->registers_)) {
+    return 0;
+  }
+  auto map = static_cast<RegisterMap>(reg);
+  switch (map) {
+    case RegisterMap::OUT_X_L:
+    case RegisterMap::OUT_X_H:
+    case RegisterMap::OUT_Y_L:
+    case RegisterMap::OUT_Y_H:
+    case RegisterMap::OUT_Z_L:
+    case RegisterMap::OUT_Z_H: {
+      uint8_t axis = (reg - static_cast<uint8_t>(RegisterMap::OUT_X_L)) / 2;
+      bool high = reg & 1;
+      int16_t value;
+      if (this->fifo_active_()) {
+        const RawFrame &frame = this->fifo_[this->fifo_head_];
+        value = axis == 0 ? frame.x : (axis == 1 ? frame.y : frame.z);
+        if (map == RegisterMap::OUT_Z_H && this->fifo_level_ > 0) {
+          this->fifo_head_ = (this->fifo_head_ + 1) % FIFO_DEPTH;
+          this->fifo_level_--;
+        }
+      } else {
+        value = this->output_[axis];
+        RegCtrl4 ctrl4;
+        ctrl4.raw = this->reg_(RegisterMap::CTRL_REG4);
+        if (ctrl4.bdu) {
+          if (high) {
+            this->bdu_held_ &= ~(1 << axis);
+          } else {
+            this->bdu_held_ |= 1 << axis;
+          }
+        }
+      }
+      if (high) {
+        // Data-ready and overrun clear once the axis has been read
+        this->reg_(RegisterMap::STATUS_REG) &= ~(0x11 << axis | 0x88);
+      }
+      return high ? static_cast<uint16_t>(value) >> 8 : value & 0xFF;
+    }
+    case RegisterMap::FIFO_SRC: {
+      RegFifoCtrl fifo_ctrl;
+      fifo_ctrl.raw = this->reg_(RegisterMap::FIFO_CTRL);
+      RegFifoSrc fifo_src;
+      fifo_src.fss = std::min<uint8_t>(this->fifo_level_, 31);
+      fifo_src.empty = this->fifo_level_ == 0;
+      fifo_src.ovrn = this->fifo_level_ == FIFO_DEPTH;
+      fifo_src.wtm = fifo_ctrl.fth > 0 && this->fifo_level_ >= fifo_ctrl.fth;
+      return fifo_src.raw;
+    }
+    case RegisterMap::INT1_SRC:
+    case RegisterMap::INT2_SRC:
+    case RegisterMap::CLICK_SRC: {
+      uint8_t value = this->registers_[reg];
+      // Latched or not, a read acknowledges the event; an unlatched source is rewritten every sample
+      this->registers_[reg] = 0;
+      return value;
+    }
+    case RegisterMap::REFERENCE:
+      // In normal mode reading REFERENCE resets the high-pass filter to the current input
+      memset(this->high_pass_output_, 0, sizeof(this->high_pass_output_));
+      return this->registers_[reg];
+    default:
+      return this->registers_[reg];
+  }
+}
+
+void LIS3DHRegisterModel::write_register_(uint8_t reg, uint8_t value) {
+  switch (static_cast<RegisterMap>(reg)) {
+    case RegisterMap::CTRL_REG1:
+    case RegisterMap::CTRL_REG2:
+    case RegisterMap::CTRL_REG3:
+    case RegisterMap::CTRL_REG4:
+    case RegisterMap::CTRL_REG6:
+    case RegisterMap::REFERENCE:
+    case RegisterMap::INT1_CFG:
+    case RegisterMap::INT1_THS:
+    case RegisterMap::INT1_DUR:
+    case RegisterMap::INT2_CFG:
+    case RegisterMap::INT2_THS:
+    case RegisterMap::INT2_DUR:
+    case RegisterMap::CLICK_CFG:
+    case RegisterMap::CLICK_THS:
+    case RegisterMap::TIME_LIMIT:
+    case RegisterMap::TIME_LATENCY:
+    case RegisterMap::TIME_WINDOW:
+    case RegisterMap::ACT_THS:
+    case RegisterMap::ACT_DUR:
+      this->registers_[reg] = value;
+      break;
+    case RegisterMap::CTRL_REG5:
+      // BOOT reloads the trimming values and clears itself
+      this->registers_[reg] = value & 0x7F;
+      break;
+    case RegisterMap::FIFO_CTRL: {
+      this->registers_[reg] = value;
+      RegFifoCtrl fifo_ctrl;
+      fifo_ctrl.raw = value;
+      if (fifo_ctrl.fm == FifoMode::BYPASS) {
+        this->fifo_head_ = 0;
+        this->fifo_level_ = 0;
+      }
+      break;
+    }
+    default:
+      // Read-only or reserved
+      break;
+  }
+}
+
+// ---- Sample generation ----
+
+bool LIS3DHRegisterModel::fifo_active_() {
+  RegCtrl5 ctrl5;
+  ctrl5.raw = this->reg_(RegisterMap::CTRL_REG5);
+  RegFifoCtrl fifo_ctrl;
+  fifo_ctrl.raw = this->reg_(RegisterMap::FIFO_CTRL);
+  return ctrl5.fifo_en && fifo_ctrl.fm != FifoMode::BYPASS;
+}
+
+uint32_t LIS3DHRegisterModel::output_data_rate_() {
+  RegCtrl1 ctrl1;
+  ctrl1.raw = this->reg_(RegisterMap::CTRL_REG1);
+  auto odr = static_cast<uint8_t>(ctrl1.odr);
+  if (odr >= sizeof(SIM_DATA_RATE_HZ) / sizeof(SIM_DATA_RATE_HZ[0])) {
+    return 0;
+  }
+  if (ctrl1.odr == DataRate::ODR_1344HZ_5376HZ_LP && ctrl1.low_power) {
+    return SIM_LOW_POWER_TOP_RATE_HZ;
+  }
+  return SIM_DATA_RATE_HZ[odr];
+}
+
+void LIS3DHRegisterModel::catch_up_() {
+  uint32_t now = micros();
+  uint32_t elapsed = now - this->last_update_us_;
+  this->last_update_us_ = now;
+  uint32_t rate = this->output_data_rate_();
+  if (rate == 0) {
+    this->phase_ = 0;
+    return;
+  }
+  this->phase_ += static_cast<uint64_t>(elapsed) * rate;
+  uint64_t limit = SIM_MAX_CATCH_UP_S * 1000000 * rate;
+  if (this->phase_ > limit) {
+    this->time_s_ += (this->phase_ - limit) / 1e6 / rate;
+    this->phase_ = limit;
+  }
+  while (this->phase_ >= 1000000) {
+    this->phase_ -= 1000000;
+    this->time_s_ += 1.0 / rate;
+    this->generate_sample_();
+  }
+}
+
+void LIS3DHRegisterModel::signal_(float *g) {
+  if (!this->trace_.empty()) {
+    const auto &row = this->trace_[this->samples_generated_ % this->trace_.size()];
+    g[0] = row[0];
+    g[1] = row[1];
+    g[2] = row[2];
+  } else {
+    for (uint8_t axis = 0; axis < 3; axis++) {
+      const Waveform &wave = this->waveform_[axis];
+      g[axis] = wave.offset;
+      if (wave.amplitude != 0.0f) {
+        g[axis] += wave.amplitude * sinf(static_cast<float>(2.0 * M_PI * fmod(wave.frequency * this->time_s_, 1.0)));
+      }
+    }
+  }
+  if (this->noise_ > 0.0f) {
+    for (uint8_t axis = 0; axis < 3; axis++) {
+      // xorshift32, mapped to [-1, 1)
+      this->noise_seed_ ^= this->noise_seed_ << 13;
+      this->noise_seed_ ^= this->noise_seed_ >> 17;
+      this->noise_seed_ ^= this->noise_seed_ << 5;
+      g[axis] += this->noise_ * (static_cast<float>(this->noise_seed_) / 2147483648.0f - 1.0f);
+    }
+  }
+}
+
+void LIS3DHRegisterModel::high_pass_(const float *g, float *filtered) {
+  // First-order high-pass with the cutoff at roughly ODR / (50 · 2^HPCF)
+  RegCtrl2 ctrl2;
+  ctrl2.raw = this->reg_(RegisterMap::CTRL_REG2);
+  float alpha = 1.0f / (1.0f + 2.0f * static_cast<float>(M_PI) / static_cast<float>(50 << ctrl2.hpcf));
+  for (uint8_t axis = 0; axis < 3; axis++) {
+    this->high_pass_output_[axis] = alpha * (this->high_pass_output_[axis] + g[axis] - this->high_pass_input_[axis]);
+    this->high_pass_input_[axis] = g[axis];
+    filtered[axis] = this->high_pass_output_[axis];
+  }
+}
+
+void LIS3DHRegisterModel::generate_sample_() {
+  this->samples_generated_++;
+
+  float g[3];
+  this->signal_(g);
+  float filtered[3];
+  this->high_pass_(g, filtered);
+
+  RegCtrl1 ctrl1;
+  ctrl1.raw = this->reg_(RegisterMap::CTRL_REG1);
+  RegCtrl2 ctrl2;
+  ctrl2.raw = this->reg_(RegisterMap::CTRL_REG2);
+  RegCtrl4 ctrl4;
+  ctrl4.raw = this->reg_(RegisterMap::CTRL_REG4);
+
+  // Left-justified output; the resolution decides how many of the low bits carry data
+  uint16_t mask = ctrl1.low_power ? 0xFF00 : (ctrl4.high_res ? 0xFFF0 : 0xFFC0);
+  float mg_per_digit = SIM_MG_PER_DIGIT[static_cast<uint8_t>(ctrl4.fs)];
+  const float *output = ctrl2.fds ? filtered : g;
+  bool enabled[3] = {ctrl1.x_enable, ctrl1.y_enable, ctrl1.z_enable};
+  int16_t raw[3];
+  for (uint8_t axis = 0; axis < 3; axis++) {
+    long digits = enabled[axis] ? lroundf(output[axis] * 1000.0f / mg_per_digit) : 0;
+    digits = std::max(-2048L, std::min(digits, 2047L));
+    raw[axis] = static_cast<int16_t>(static_cast<uint16_t>(digits * 16) & mask);
+  }
+
+  this->store_output_(raw);
+  if (this->fifo_active_()) {
+    this->push_fifo_(raw);
+  }
+
+  this->run_interrupt_generator_(0, ctrl2.hp_ia1 ? filtered : g);
+  this->run_interrupt_generator_(1, ctrl2.hp_ia2 ? filtered : g);
+  this->run_click_detector_(ctrl2.hpclick ? filtered : g);
+}
+
+void LIS3DHRegisterModel::store_output_(const int16_t *raw) {
+  RegCtrl4 ctrl4;
+  ctrl4.raw = this->reg_(RegisterMap::CTRL_REG4);
+  uint8_t &status = this->reg_(RegisterMap::STATUS_REG);
+  for (uint8_t axis = 0; axis < 3; axis++) {
+    // With BDU an axis whose low byte has been read keeps its value until the high byte is read too
+    if (ctrl4.bdu && (this->bdu_held_ & (1 << axis))) {
+      continue;
+    }
+    this->output_[axis] = raw[axis];
+  }
+  // A sample arriving before the previous one was read sets the overrun bits
+  status |= (status & 0x0F) << 4;
+  status |= 0x0F;
+}
+
+void LIS3DHRegisterModel::push_fifo_(const int16_t *raw) {
+  RegFifoCtrl fifo_ctrl;
+  fifo_ctrl.raw = this->reg_(RegisterMap::FIFO_CTRL);
+  if (this->fifo_level_ == FIFO_DEPTH) {
+    // FIFO mode stops when full; stream modes discard the oldest frame
+    if (fifo_ctrl.fm == FifoMode::FIFO) {
+      return;
+    }
+    this->fifo_head_ = (this->fifo_head_ + 1) % FIFO_DEPTH;
+    this->fifo_level_--;
+  }
+  RawFrame &slot = this->fifo_[(this->fifo_head_ + this->fifo_level_) % FIFO_DEPTH];
+  slot.x = raw[0];
+  slot.y = raw[1];
+  slot.z = raw[2];
+  this->fifo_level_++;
+}
+
+void LIS3DHRegisterModel::run_interrupt_generator_(uint8_t index, const float *g) {
+  uint8_t base = static_cast<uint8_t>(index == 0 ? RegisterMap::INT1_CFG : RegisterMap::INT2_CFG);
+  RegIntCfg cfg;
+  cfg.raw = this->registers_[base];
+  uint8_t enabled = cfg.raw & 0x3F;
+  if (enabled == 0) {
+    return;
+  }
+  RegCtrl4 ctrl4;
+  ctrl4.raw = this->reg_(RegisterMap::CTRL_REG4);
+  float threshold = (this->registers_[base + 2] & 0x7F) * SIM_INT_THS_MG[static_cast<uint8_t>(ctrl4.fs)];
+  uint8_t duration = this->registers_[base + 3] & 0x7F;
+  InterruptGenerator &generator = this->generators_[index];
+
+  // XL/XH, YL/YH, ZL/ZH as in INTx_SRC
+  uint8_t events = 0;
+  bool active;
+  if (cfg.sixd) {
+    // 6D: a position is one axis beyond the threshold, in either direction, with the other two inside it
+    uint8_t beyond = 0;
+    for (uint8_t axis = 0; axis < 3; axis++) {
+      float mg = g[axis] * 1000.0f;
+      if (mg > threshold) {
+        events |= 0x02 << (2 * axis);
+        beyond++;
+      } else if (mg < -threshold) {
+        events |= 0x01 << (2 * axis);
+        beyond++;
+      }
+    }
+    events = beyond == 1 ? events & enabled : 0;
+    if (cfg.aoi) {
+      // Position recognition: active while in a known position
+      active = events != 0;
+    } else {
+      // Movement recognition: active when the position changes
+      active = events != 0 && events != generator.position;
+      if (events != 0) {
+        generator.position = events;
+      }
+    }
+  } else {
+    for (uint8_t axis = 0; axis < 3; axis++) {
+      bool high = fabsf(g[axis] * 1000.0f) > threshold;
+      events |= (high ? 0x02 : 0x01) << (2 * axis);
+    }
+    uint8_t matched = events & enabled;
+    active = cfg.aoi ? matched == enabled : matched != 0;
+  }
+
+  bool fire = false;
+  if (active) {
+    generator.duration = std::min<uint8_t>(generator.duration + 1, 0xFF);
+    fire = generator.duration > duration;
+  } else {
+    generator.duration = 0;
+  }
+
+  RegCtrl5 ctrl5;
+  ctrl5.raw = this->reg_(RegisterMap::CTRL_REG5);
+  bool latched = index == 0 ? ctrl5.lir_int1 : ctrl5.lir_int2;
+  uint8_t &source = this->registers_[base + 1];
+  RegIntSrc current;
+  current.raw = source;
+  if (latched && current.ia) {
+    return;
+  }
+  current.raw = events;
+  current.ia = fire;
+  if (latched && !fire) {
+    return;
+  }
+  source = current.raw;
+}
+
+void LIS3DHRegisterModel::run_click_detector_(const float *g) {
+  RegClickCfg cfg;
+  cfg.raw = this->reg_(RegisterMap::CLICK_CFG);
+  uint8_t enabled = cfg.raw & 0x3F;
+  if (enabled == 0) {
+    return;
+  }
+  RegCtrl4 ctrl4;
+  ctrl4.raw = this->reg_(RegisterMap::CTRL_REG4);
+  float threshold =
+      (this->reg_(RegisterMap::CLICK_THS) & 0x7F) * SIM_CLICK_THS_MG[static_cast<uint8_t>(ctrl4.fs)];
+
+  // The strongest enabled axis above the threshold, if any
+  int8_t over = -1;
+  float peak = threshold;
+  for (uint8_t axis = 0; axis < 3; axis++) {
+    float mg = fabsf(g[axis] * 1000.0f);
+    if ((enabled & (0x03 << (2 * axis))) && mg > peak) {
+      over = axis;
+      peak = mg;
+    }
+  }
+  bool wants_double = enabled & 0x2A;
+
+  // Without LIR_Click the source only shows the sample that completed the click
+  if (!(this->reg_(RegisterMap::CLICK_THS) & 0x80)) {
+    this->reg_(RegisterMap::CLICK_SRC) = 0;
+  }
+
+  switch (this->click_.state) {
+    case ClickState::WINDOW:
+      if (over < 0) {
+        if (++this->click_.count > this->reg_(RegisterMap::TIME_WINDOW)) {
+          this->click_.state = ClickState::IDLE;
+        }
+        break;
+      }
+      // A pulse inside the window is the second click
+      [[fallthrough]];
+    case ClickState::IDLE:
+      if (over >= 0) {
+        this->click_.second = this->click_.state == ClickState::WINDOW;
+        this->click_.state = ClickState::PULSE;
+        this->click_.count = 0;
+        this->click_.axis = over;
+        this->click_.negative = g[over] < 0.0f;
+      }
+      break;
+    case ClickState::PULSE:
+      if (over >= 0) {
+        // Still above the threshold: too long to be a click once TIME_LIMIT has passed
+        if (++this->click_.count > (this->reg_(RegisterMap::TIME_LIMIT) & 0x7F)) {
+          this->click_.state = ClickState::TOO_LONG;
+        }
+        break;
+      }
+      if (this->click_.second) {
+        this->report_click_(true);
+        this->click_.state = ClickState::IDLE;
+      } else {
+        this->report_click_(false);
+        this->click_.state = wants_double ? ClickState::LATENCY : ClickState::IDLE;
+        this->click_.count = 0;
+      }
+      break;
+    case ClickState::TOO_LONG:
+      if (over < 0) {
+        this->click_.state = ClickState::IDLE;
+      }
+      break;
+    case ClickState::LATENCY:
+      if (++this->click_.count >= this->reg_(RegisterMap::TIME_LATENCY)) {
+        this->click_.state = ClickState::WINDOW;
+        this->click_.count = 0;
+      }
+      break;
+  }
+}
+
+void LIS3DHRegisterModel::report_click_(bool double_click) {
+  RegClickCfg cfg;
+  cfg.raw = this->reg_(RegisterMap::CLICK_CFG);
+  uint8_t axis_bit = double_click ? 0x02 << (2 * this->click_.axis) : 0x01 << (2 * this->click_.axis);
+  if (!(cfg.raw & axis_bit)) {
+    return;
+  }
+  uint8_t &source = this->reg_(RegisterMap::CLICK_SRC);
+  RegClickSrc current;
+  current.raw = source;
+  // LIR_Click in CLICK_THS bit 7: keep the first event until CLICK_SRC is read
+  if ((this->reg_(RegisterMap::CLICK_THS) & 0x80) && current.ia) {
+    return;
+  }
+  current.raw = 1 << this->click_.axis;
+  current.sign = this->click_.negative;
+  current.single_click = !double_click;
+  current.double_click = double_click;
+  current.ia = true;
+  source = current.raw;
+}
+
+}  // namespace lis3dh
+}  // namespace esphome
+
+#endif  // USE_LIS3DH_SIMULATOR
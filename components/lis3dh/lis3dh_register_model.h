@@ -0,0 +1,126 @@
+#pragma once
+
+#include "esphome/core/defines.h"
+
+#ifdef USE_LIS3DH_SIMULATOR
+
+#include "lis3dh.h"
+
+#include <array>
+#include <atomic>
+#include <string>
+#include <vector>
+
+namespace esphome {
+namespace lis3dh {
+
+/// Register-level model of the chip for the host platform. It produces samples at the configured
+/// data rate from a waveform or a replayed trace and implements what the driver relies on:
+/// auto-increment (including the OUT_Z_H → OUT_X_L wrap in FIFO mode), BDU, STATUS_REG data-ready
+/// and overrun bits, the 32-level FIFO in FIFO/stream mode, both interrupt generators (AND/OR and
+/// 6D), single/double click detection, the normal-mode high-pass filter, and latched
+/// INT1_SRC/INT2_SRC/CLICK_SRC that clear on read.
+///
+/// Not modelled: the INT1/INT2 pins (leave them unset so the driver polls the sources),
+/// sleep-to-wake, self-test, the auxiliary ADC and the temperature sensor.
+class LIS3DHRegisterModel {
+ public:
+  LIS3DHRegisterModel() { this->power_on_reset(); }
+
+  /// Back to the power-on register values with an empty FIFO, as after a brown-out
+  void power_on_reset();
+  /// power_on_reset() on the next bus access, so it can be called while the acquisition task uses the model
+  void power_cycle() { this->power_cycle_pending_ = true; }
+
+  /// Signal on one axis (0 = X, 1 = Y, 2 = Z) in g: offset + amplitude · sin(2π · frequency · t)
+  void set_waveform(uint8_t axis, float offset, float amplitude, float frequency);
+  /// Uniform noise of ± amplitude g added to every axis
+  void set_noise(float amplitude) { this->noise_ = amplitude; }
+  /// Replays X,Y,Z rows in g from a CSV file, one row per sample, looping at the end.
+  /// Lines that don't parse (headers, comments) are skipped; returns false if nothing was read.
+  bool load_trace(const std::string &path);
+  size_t get_trace_length() const { return this->trace_.size(); }
+
+  /// I2C-style access: bit 7 of sub_address makes the register pointer auto-increment
+  void read(uint8_t sub_address, uint8_t *data, size_t len);
+  void write(uint8_t sub_address, const uint8_t *data, size_t len);
+
+  uint32_t get_samples_generated() const { return this->samples_generated_; }
+
+ protected:
+  struct InterruptGenerator {
+    uint8_t position{0};
+    uint8_t duration{0};
+  };
+
+  enum class ClickState : uint8_t {
+    IDLE,
+    PULSE,
+    TOO_LONG,
+    LATENCY,
+    WINDOW,
+  };
+
+  void catch_up_();
+  void generate_sample_();
+  void signal_(float *g);
+  void high_pass_(const float *g, float *filtered);
+  void store_output_(const int16_t *raw);
+  void push_fifo_(const int16_t *raw);
+  void run_interrupt_generator_(uint8_t index, const float *g);
+  void run_click_detector_(const float *g);
+  void report_click_(bool double_click);
+
+  uint8_t read_register_(uint8_t reg);
+  void write_register_(uint8_t reg, uint8_t value);
+  uint8_t &reg_(RegisterMap reg) { return this->registers_[static_cast<uint8_t>(reg)]; }
+
+  bool fifo_active_();
+  uint32_t output_data_rate_();
+
+  uint8_t registers_[0x40];
+  std::atomic<bool> power_cycle_pending_{false};
+
+  // Output registers and the BDU hold mask (bit n = axis n has had its low byte read, not its high byte)
+  int16_t output_[3];
+  uint8_t bdu_held_{0};
+
+  RawFrame fifo_[FIFO_DEPTH];
+  uint8_t fifo_head_{0};
+  uint8_t fifo_level_{0};
+
+  // Normal-mode high-pass filter state per axis, reset by reading REFERENCE
+  float high_pass_input_[3];
+  float high_pass_output_[3];
+
+  InterruptGenerator generators_[2];
+
+  struct {
+    ClickState state{ClickState::IDLE};
+    uint8_t count{0};
+    uint8_t axis{0};
+    bool negative{false};
+    bool second{false};
+  } click_;
+
+  // Sample clock: µs·Hz accumulated since the last sample, one sample per 1 000 000
+  uint32_t last_update_us_{0};
+  uint64_t phase_{0};
+  double time_s_{0.0};
+  uint32_t samples_generated_{0};
+
+  struct Waveform {
+    float offset;
+    float amplitude;
+    float frequency;
+  };
+  Waveform waveform_[3]{{0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}};
+  float noise_{0.0f};
+  uint32_t noise_seed_{0x12345678};
+  std::vector<std::array<float, 3>> trace_;
+};
+
+}  // namespace lis3dh
+}  // namespace esphome
+
+#endif  // USE_LIS3DH_SIMULATOR
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+namespace lis3dh {
+
+/// Lock-free single-producer/single-consumer ring of fixed-size items. One side may only call
+/// push(), the other only pop(); no other synchronisation is needed between them.
+/// N must be a power of two; the indices run freely and wrap naturally.
+template<typename T, size_t N> class SpscRing {
+  static_assert((N & (N - 1)) == 0, "ring size must be a power of two");
+
+ public:
+  /// Producer side; drops the item and counts it when the consumer has fallen a full ring behind
+  bool push(const T &item) {
+    uint32_t head = this->head_.load(std::memory_order_relaxed);
+    if (head - this->tail_.load(std::memory_order_acquire) == N) {
+      this->dropped_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    this->items_[head % N] = item;
+    this->head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// Consumer side
+  bool pop(T &item) {
+    uint32_t tail = this->tail_.load(std::memory_order_relaxed);
+    if (tail == this->head_.load(std::memory_order_acquire))
+      return false;
+    item = this->items_[tail % N];
+    this->tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  uint32_t get_dropped() const { return this->dropped_.load(std::memory_order_relaxed); }
+
+ protected:
+  T items_[N]{};
+  std::atomic<uint32_t> head_{0};
+  std::atomic<uint32_t> tail_{0};
+  std::atomic<uint32_t> dropped_{0};
+};
+
+}  // namespace lis3dh
+}  // namespace esphome
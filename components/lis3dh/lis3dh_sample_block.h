@@ -0,0 +1,93 @@
+#pragma once
+
+#include "lis3dh_math.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+namespace lis3dh {
+
+/// Bytes per X/Y/Z output frame (three little-endian 16-bit words)
+static const uint8_t FRAME_SIZE = 6;
+
+// ---- Structure-of-arrays sample block ----
+//
+// Everything that consumes more than one sample at a time (FIFO drains, statistics, Goertzel,
+// spectrum) works on one of these instead of converting frame by frame. Each channel is a
+// contiguous int16 array, so the kernels below are plain counted loops over independent
+// elements: GCC vectorizes them on the host, and on Xtensa/RISC-V they compile to tight
+// hardware/zero-overhead loops without calls or branches in the body.
+
+/// Up to N frames in raw 12-bit-equivalent digits, one array per channel
+template<size_t N> struct SampleBlock {
+  int16_t x[N];
+  int16_t y[N];
+  int16_t z[N];
+  /// Vector magnitude per frame; filled by compute_magnitude() only when a consumer needs it
+  int16_t magnitude[N];
+  size_t size{0};
+  bool has_magnitude{false};
+
+  static constexpr size_t capacity() { return N; }
+
+  /// Sign-extends and right-justifies `frames` little-endian, left-justified X/Y/Z frames as
+  /// they come off the bus (the low 4 bits are padding in every resolution mode)
+  void decode(const uint8_t *__restrict data, size_t frames) {
+    decode_axis_(data + 0, this->x, frames);
+    decode_axis_(data + 2, this->y, frames);
+    decode_axis_(data + 4, this->z, frames);
+    this->size = frames;
+    this->has_magnitude = false;
+  }
+
+  /// Appends one frame (used when frames arrive one by one through the acquisition ring)
+  void push(int16_t raw_x, int16_t raw_y, int16_t raw_z) {
+    this->x[this->size] = raw_x;
+    this->y[this->size] = raw_y;
+    this->z[this->size] = raw_z;
+    this->size++;
+    this->has_magnitude = false;
+  }
+
+  bool full() const { return this->size == N; }
+  void clear() {
+    this->size = 0;
+    this->has_magnitude = false;
+  }
+
+  /// Fills magnitude[]; ≤ 2048·√3 digits, so it fits in int16
+  void compute_magnitude() {
+    if (this->has_magnitude)
+      return;
+    for (size_t i = 0; i < this->size; i++)
+      this->magnitude[i] = static_cast<int16_t>(vector_magnitude(this->x[i], this->y[i], this->z[i]));
+    this->has_magnitude = true;
+  }
+
+  /// Contiguous samples of `channel`; computes the magnitude array on first use
+  const int16_t *channel(SampleChannel channel) {
+    switch (channel) {
+      case SampleChannel::X:
+        return this->x;
+      case SampleChannel::Y:
+        return this->y;
+      case SampleChannel::Z:
+        return this->z;
+      default:
+        this->compute_magnitude();
+        return this->magnitude;
+    }
+  }
+
+ protected:
+  static void decode_axis_(const uint8_t *__restrict data, int16_t *__restrict out, size_t frames) {
+    for (size_t i = 0; i < frames; i++) {
+      const uint8_t *word = data + i * FRAME_SIZE;
+      out[i] = static_cast<int16_t>(static_cast<uint16_t>(word[1] << 8 | word[0])) >> 4;
+    }
+  }
+};
+
+}  // namespace lis3dh
+}  // namespace esphome
@@ -0,0 +1,244 @@
+#include "lis3dh_sim_component.h"
+
+#ifdef USE_LIS3DH_SIMULATOR
+
+#include "esphome/core/hal.h"
+#include "esphome/core/log.h"
+
+#include <cstring>
+
+#ifdef USE_LIS3DH_BENCHMARK
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#endif
+
+namespace esphome {
+namespace lis3dh {
+
+static const char *const TAG = "lis3dh.sim";
+
+#ifdef USE_LIS3DH_BENCHMARK
+// Heap allocations are counted only in loop() or update() of a simulated instance and on the
+// acquisition task, so the report shows what the driver allocates and not the rest of the firmware
+static std::atomic<uint32_t> driver_allocations{0};
+thread_local bool in_driver = false;
+
+/// Marks the calling thread as running driver code and measures how long that takes
+class DriverSection {
+ public:
+  DriverSection() : start_(std::chrono::steady_clock::now()) { in_driver = true; }
+  uint32_t finish() {
+    in_driver = false;
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - this->start_)
+        .count();
+  }
+
+ protected:
+  std::chrono::steady_clock::time_point start_;
+};
+#endif
+
+i2c::ErrorCode LIS3DHSimBus::writev(uint8_t address, i2c::WriteBuffer *buffers, size_t cnt, bool stop) {
+  if (!this->connected_ || address != SIM_I2C_ADDRESS) {
+    return i2c::ERROR_NOT_ACKNOWLEDGED;
+  }
+  uint8_t transfer[MAX_TRANSFER];
+  size_t len = 0;
+  for (size_t i = 0; i < cnt; i++) {
+    if (len + buffers[i].len > MAX_TRANSFER) {
+      return i2c::ERROR_TOO_LARGE;
+    }
+    std::memcpy(transfer + len, buffers[i].data, buffers[i].len);
+    len += buffers[i].len;
+  }
+  if (len == 0) {
+    return i2c::ERROR_INVALID_ARGUMENT;
+  }
+  // The first byte is the sub-address; anything after it is register data
+  if (len > 1) {
+    this->chip_->write(transfer[0], transfer + 1, len - 1);
+  }
+  // A bare sub-address points the next read at that register; the chip keeps it across a stop
+  this->read_sub_address_ = len == 1 ? transfer[0] : -1;
+  this->bytes_ += len;
+  if (stop) {
+    this->transactions_++;
+  }
+  return i2c::ERROR_OK;
+}
+
+i2c::ErrorCode LIS3DHSimBus::readv(uint8_t address, i2c::ReadBuffer *buffers, size_t cnt) {
+  if (!this->connected_ || address != SIM_I2C_ADDRESS) {
+    return i2c::ERROR_NOT_ACKNOWLEDGED;
+  }
+  // The model has no register pointer of its own, so a read needs the sub-address written first
+  if (this->read_sub_address_ < 0) {
+    return i2c::ERROR_INVALID_ARGUMENT;
+  }
+  size_t len = 0;
+  for (size_t i = 0; i < cnt; i++) {
+    len += buffers[i].len;
+  }
+  if (len > MAX_TRANSFER) {
+    return i2c::ERROR_TOO_LARGE;
+  }
+  // One burst, so auto-increment and the FIFO wrap behave as on the chip
+  uint8_t transfer[MAX_TRANSFER];
+  this->chip_->read(this->read_sub_address_, transfer, len);
+  size_t offset = 0;
+  for (size_t i = 0; i < cnt; i++) {
+    std::memcpy(buffers[i].data, transfer + offset, buffers[i].len);
+    offset += buffers[i].len;
+  }
+  this->read_sub_address_ = -1;
+  this->bytes_ += len;
+  this->transactions_++;
+  return i2c::ERROR_OK;
+}
+
+void LIS3DHSimComponent::setup() {
+  // The base setup comes first so the instance joins its bus scheduler even if the trace is bad;
+  // the acquisition task waits for every instance to have joined
+  LIS3DHI2CComponent::setup();
+  if (this->is_failed()) {
+    return;
+  }
+  if (!this->trace_path_.empty() && !this->chip_.load_trace(this->trace_path_)) {
+    ESP_LOGE(TAG, "Couldn't read any X,Y,Z rows from %s", this->trace_path_.c_str());
+    this->mark_failed();
+    return;
+  }
+#ifdef USE_LIS3DH_BENCHMARK
+  this->benchmark_mark_.time_ms = millis();
+  this->benchmark_mark_.transactions = this->sim_bus_.get_transactions();
+  this->benchmark_mark_.bytes = this->sim_bus_.get_bytes();
+  this->benchmark_mark_.samples = this->acquisition_.samples_read;
+  this->benchmark_mark_.allocations = driver_allocations;
+  this->set_interval("benchmark", this->benchmark_interval_ms_, [this]() { this->report_benchmark_(); });
+#endif
+}
+
+void LIS3DHSimComponent::dump_config() {
+  LIS3DHI2CComponent::dump_config();
+  ESP_LOGCONFIG(TAG, "  Bus: simulated");
+  if (this->chip_.get_trace_length() > 0) {
+    ESP_LOGCONFIG(TAG, "  Trace: %s (%zu samples)", this->trace_path_.c_str(), this->chip_.get_trace_length());
+  }
+  ESP_LOGCONFIG(TAG, "  Simulated: %" PRIu32 " samples generated, %" PRIu32 " transactions, %" PRIu32 " bytes",
+                this->chip_.get_samples_generated(), this->sim_bus_.get_transactions(), this->sim_bus_.get_bytes());
+#ifdef USE_LIS3DH_BENCHMARK
+  ESP_LOGCONFIG(TAG, "  Benchmark report every %.1fs", this->benchmark_interval_ms_ / 1000.0f);
+#endif
+}
+
+#ifdef USE_LIS3DH_BENCHMARK
+void LIS3DHSimComponent::loop() {
+  DriverSection section;
+  LIS3DHI2CComponent::loop();
+  this->loop_stats_.add(section.finish());
+}
+
+void LIS3DHSimComponent::update() {
+  DriverSection section;
+  LIS3DHI2CComponent::update();
+  this->update_stats_.add(section.finish());
+}
+
+void LIS3DHSimComponent::report_benchmark_() {
+  uint32_t now = millis();
+  uint32_t transactions = this->sim_bus_.get_transactions() - this->benchmark_mark_.transactions;
+  uint32_t bytes = this->sim_bus_.get_bytes() - this->benchmark_mark_.bytes;
+  uint32_t samples = this->acquisition_.samples_read - this->benchmark_mark_.samples;
+  uint32_t allocations = driver_allocations - this->benchmark_mark_.allocations;
+
+  ESP_LOGI(TAG, "Benchmark over %.1fs:", (now - this->benchmark_mark_.time_ms) / 1000.0f);
+  ESP_LOGI(TAG, "  loop():   %" PRIu32 " calls, %.2f µs mean, %.2f µs max", this->loop_stats_.calls,
+           this->loop_stats_.mean_us(), this->loop_stats_.max_ns / 1000.0f);
+  ESP_LOGI(TAG, "  update(): %" PRIu32 " calls, %.2f µs mean, %.2f µs max", this->update_stats_.calls,
+           this->update_stats_.mean_us(), this->update_stats_.max_ns / 1000.0f);
+  if (samples > 0) {
+    ESP_LOGI(TAG,
+             "  Bus: %" PRIu32 " transactions, %" PRIu32 " bytes for %" PRIu32
+             " samples (%.3f transactions, %.2f bytes per sample)",
+             transactions, bytes, samples, static_cast<float>(transactions) / samples,
+             static_cast<float>(bytes) / samples);
+  } else {
+    ESP_LOGI(TAG, "  Bus: %" PRIu32 " transactions, %" PRIu32 " bytes, no samples", transactions, bytes);
+  }
+  ESP_LOGI(TAG, "  Heap allocations in the driver: %" PRIu32, allocations);
+
+  this->loop_stats_ = {};
+  this->update_stats_ = {};
+  this->benchmark_mark_.time_ms = now;
+  this->benchmark_mark_.transactions = this->sim_bus_.get_transactions();
+  this->benchmark_mark_.bytes = this->sim_bus_.get_bytes();
+  this->benchmark_mark_.samples = this->acquisition_.samples_read;
+  this->benchmark_mark_.allocations = driver_allocations;
+}
+#endif
+
+}  // namespace lis3dh
+}  // namespace esphome
+
+#ifdef USE_LIS3DH_BENCHMARK
+// Replacing the global allocator is the only way to see allocations made inside the standard
+// library on the driver's behalf. Every plain, array, nothrow and aligned form is replaced, together
+// with all the deletes, so none of them can pair with the library's own allocator.
+static void *counted_alloc(size_t size) {
+  if (esphome::lis3dh::in_driver) {
+    esphome::lis3dh::driver_allocations++;
+  }
+  return malloc(size == 0 ? 1 : size);
+}
+
+static void *counted_aligned_alloc(size_t size, std::align_val_t alignment) {
+  if (esphome::lis3dh::in_driver) {
+    esphome::lis3dh::driver_allocations++;
+  }
+  // aligned_alloc() wants the size to be a multiple of the alignment; free() releases it
+  size_t align = static_cast<size_t>(alignment);
+  return aligned_alloc(align, (std::max<size_t>(size, 1) + align - 1) / align * align);
+}
+
+void *operator new(size_t size) {
+  void *ptr = counted_alloc(size);
+  if (ptr == nullptr) {
+    abort();
+  }
+  return ptr;
+}
+void *operator new[](size_t size) { return operator new(size); }
+void *operator new(size_t size, const std::nothrow_t &) noexcept { return counted_alloc(size); }
+void *operator new[](size_t size, const std::nothrow_t &) noexcept { return counted_alloc(size); }
+void *operator new(size_t size, std::align_val_t alignment) {
+  void *ptr = counted_aligned_alloc(size, alignment);
+  if (ptr == nullptr) {
+    abort();
+  }
+  return ptr;
+}
+void *operator new[](size_t size, std::align_val_t alignment) { return operator new(size, alignment); }
+void *operator new(size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+  return counted_aligned_alloc(size, alignment);
+}
+void *operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+  return counted_aligned_alloc(size, alignment);
+}
+
+void operator delete(void *ptr) noexcept { free(ptr); }
+void operator delete[](void *ptr) noexcept { free(ptr); }
+void operator delete(void *ptr, size_t) noexcept { free(ptr); }
+void operator delete[](void *ptr, size_t) noexcept { free(ptr); }
+void operator delete(void *ptr, const std::nothrow_t &) noexcept { free(ptr); }
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept { free(ptr); }
+void operator delete(void *ptr, std::align_val_t) noexcept { free(ptr); }
+void operator delete[](void *ptr, std::align_val_t) noexcept { free(ptr); }
+void operator delete(void *ptr, size_t, std::align_val_t) noexcept { free(ptr); }
+void operator delete[](void *ptr, size_t, std::align_val_t) noexcept { free(ptr); }
+void operator delete(void *ptr, std::align_val_t, const std::nothrow_t &) noexcept { free(ptr); }
+void operator delete[](void *ptr, std::align_val_t, const std::nothrow_t &) noexcept { free(ptr); }
+#endif
+
+#endif  // USE_LIS3DH_SIMULATOR
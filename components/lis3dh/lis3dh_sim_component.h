@@ -0,0 +1,123 @@
+#pragma once
+
+#include "esphome/core/defines.h"
+
+#ifdef USE_LIS3DH_SIMULATOR
+
+#include "lis3dh_i2c.h"
+#include "lis3dh_register_model.h"
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+
+namespace esphome {
+namespace lis3dh {
+
+#ifdef USE_LIS3DH_BENCHMARK
+/// Set while the calling thread runs driver code; the benchmark only counts heap allocations then.
+/// The acquisition task sets it for good, as it runs nothing else.
+extern thread_local bool in_driver;
+#endif
+
+/// Bus address of the model (SA0 low)
+static const uint8_t SIM_I2C_ADDRESS = 0x18;
+
+/// I2C bus stand-in with the register model as its only device. It follows the LIS3DH framing: a
+/// write starts with the sub-address, and a read continues from the sub-address written before it.
+class LIS3DHSimBus : public i2c::I2CBus {
+ public:
+  explicit LIS3DHSimBus(LIS3DHRegisterModel *chip) : chip_(chip) {}
+
+  i2c::ErrorCode readv(uint8_t address, i2c::ReadBuffer *buffers, size_t cnt) override;
+  i2c::ErrorCode writev(uint8_t address, i2c::WriteBuffer *buffers, size_t cnt, bool stop) override;
+
+  /// A disconnected chip doesn't acknowledge its address, e.g. to exercise the recovery path
+  void set_connected(bool connected) { this->connected_ = connected; }
+
+  /// Transfers that ended in a stop condition, and the bytes they moved after the address byte
+  uint32_t get_transactions() const { return this->transactions_; }
+  uint32_t get_bytes() const { return this->bytes_; }
+
+ protected:
+  /// Longest transfer: a full FIFO plus the sub-address
+  static const size_t MAX_TRANSFER = 1 + FIFO_DEPTH * sizeof(RawFrame);
+
+  LIS3DHRegisterModel *chip_;
+  bool connected_{true};
+  /// Sub-address of a write that carried no data, which the next read continues from
+  int16_t read_sub_address_{-1};
+  /// Updated from the acquisition task when it is enabled
+  std::atomic<uint32_t> transactions_{0};
+  std::atomic<uint32_t> bytes_{0};
+};
+
+/// Runs the I2C driver against LIS3DHRegisterModel on the host platform, through LIS3DHSimBus. The
+/// driver's framing (auto-increment bit, error mapping) is the one a real bus gets, and so are the
+/// transaction and byte counts, minus start/stop conditions.
+class LIS3DHSimComponent : public LIS3DHI2CComponent {
+ public:
+  LIS3DHSimComponent() {
+    this->set_i2c_bus(&this->sim_bus_);
+    this->set_i2c_address(SIM_I2C_ADDRESS);
+  }
+
+  void setup() override;
+  void dump_config() override;
+#ifdef USE_LIS3DH_BENCHMARK
+  void loop() override;
+  void update() override;
+
+  /// Logs cycle cost, bus traffic per sample and allocations every `interval_ms`
+  void set_benchmark_interval(uint32_t interval_ms) { this->benchmark_interval_ms_ = interval_ms; }
+#endif
+
+  void set_waveform(uint8_t axis, float offset, float amplitude, float frequency) {
+    this->chip_.set_waveform(axis, offset, amplitude, frequency);
+  }
+  void set_noise(float amplitude) { this->chip_.set_noise(amplitude); }
+  void set_trace(const std::string &path) { this->trace_path_ = path; }
+
+  /// The simulated chip, e.g. for a lambda that calls power_cycle() to exercise the recovery path
+  LIS3DHRegisterModel *get_chip() { return &this->chip_; }
+  LIS3DHSimBus *get_sim_bus() { return &this->sim_bus_; }
+
+ protected:
+  LIS3DHRegisterModel chip_;
+  LIS3DHSimBus sim_bus_{&this->chip_};
+  std::string trace_path_;
+
+#ifdef USE_LIS3DH_BENCHMARK
+  struct CycleStats {
+    uint32_t calls{0};
+    uint64_t total_ns{0};
+    uint32_t max_ns{0};
+
+    void add(uint32_t ns) {
+      this->calls++;
+      this->total_ns += ns;
+      this->max_ns = std::max(this->max_ns, ns);
+    }
+    float mean_us() const { return this->calls == 0 ? 0.0f : this->total_ns / 1000.0f / this->calls; }
+  };
+
+  void report_benchmark_();
+
+  uint32_t benchmark_interval_ms_{60000};
+  CycleStats loop_stats_{};
+  CycleStats update_stats_{};
+  /// Counters at the start of the current report interval
+  struct {
+    uint32_t time_ms{0};
+    uint32_t transactions{0};
+    uint32_t bytes{0};
+    uint32_t samples{0};
+    uint32_t allocations{0};
+  } benchmark_mark_;
+#endif
+};
+
+}  // namespace lis3dh
+}  // namespace esphome
+
+#endif  // USE_LIS3DH_SIMULATOR
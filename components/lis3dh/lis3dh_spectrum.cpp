@@ -0,0 +1,248 @@
+#include "lis3dh_spectrum.h"
+
+#ifdef USE_LIS3DH_SPECTRUM
+
+#include "esphome/core/hal.h"
+#include "esphome/core/log.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace esphome {
+namespace lis3dh {
+
+static const char *const TAG = "lis3dh.spectrum";
+
+/// Window samples, butterflies or bins between two checks of the time budget
+static const uint16_t STEPS_PER_CHECK = 16;
+
+void SpectrumAnalyzer::setup(float sample_rate, float digit_scale) {
+  this->sample_rate_ = sample_rate;
+  this->digit_scale_ = digit_scale;
+
+  uint16_t n = this->block_size_;
+  this->collect_.resize(n);
+  this->pending_.resize(n);
+  this->work_.resize(n);
+  this->twiddle_cos_.resize(n / 2);
+  this->twiddle_sin_.resize(n / 2);
+  for (uint16_t k = 0; k < n / 2; k++) {
+    float angle = 2.0f * static_cast<float>(M_PI) * k / n;
+    this->twiddle_cos_[k] = cosf(angle);
+    this->twiddle_sin_[k] = sinf(angle);
+  }
+
+  // Mean of the squared Hann window, to undo its attenuation in the band energies
+  float sum = 0.0f;
+  for (uint16_t i = 0; i < n; i++) {
+    float w = 0.5f - 0.5f * cosf(2.0f * static_cast<float>(M_PI) * i / n);
+    sum += w * w;
+  }
+  this->window_power_ = sum / n;
+}
+
+void SpectrumAnalyzer::dump_config() {
+  ESP_LOGCONFIG(TAG,
+                "  Spectrum:\n"
+                "    Block Size: %u samples (%.2f Hz per bin)\n"
+                "    Time Budget: %" PRIu32 " us per loop",
+                this->block_size_, this->sample_rate_ / this->block_size_, this->time_budget_us_);
+  LOG_SENSOR("    ", "Dominant Frequency", this->dominant_frequency_sensor_);
+  for (auto &band : this->bands_) {
+    ESP_LOGCONFIG(TAG, "    Band %.1f-%.1f Hz:", band.min_frequency, band.max_frequency);
+    LOG_SENSOR("      ", "Band", band.sensor);
+  }
+}
+
+void SpectrumAnalyzer::on_block_collected_() {
+  this->collected_ = 0;
+  int32_t sum = this->collect_sum_;
+  this->collect_sum_ = 0;
+  if (this->stage_ != Stage::IDLE) {
+    // Still busy with the previous block; skip this one rather than fall further behind
+    this->dropped_blocks_++;
+    return;
+  }
+  // Hand the block to the analysis and keep collecting into the other buffer; no copy here
+  std::swap(this->collect_, this->pending_);
+  this->pending_mean_ = static_cast<float>(sum) / this->block_size_;
+  this->cursor_ = 0;
+  this->reversed_ = 0;
+  this->stage_ = Stage::WINDOW;
+}
+
+bool SpectrumAnalyzer::out_of_time_(uint32_t start_us) {
+  if (++this->budget_check_ < STEPS_PER_CHECK)
+    return false;
+  this->budget_check_ = 0;
+  return micros() - start_us >= this->time_budget_us_;
+}
+
+bool SpectrumAnalyzer::run_window_(uint32_t start_us) {
+  uint16_t n = this->block_size_;
+  uint16_t half = n / 2;
+
+  // Consecutive real samples form the packed complex sequence z[m] = x[2m] + i·x[2m+1]. Each pair is
+  // windowed (DC removed so gravity doesn't leak into the low bins) and written straight to its
+  // bit-reversed slot for the iterative radix-2 transform.
+  for (; this->cursor_ < half; this->cursor_++) {
+    if (this->out_of_time_(start_us))
+      return false;
+    uint16_t m = this->cursor_;
+    if (m > 0) {
+      // Advance the reversed counter from rev(m - 1) to rev(m)
+      uint16_t bit = half >> 1;
+      for (; this->reversed_ & bit; bit >>= 1)
+        this->reversed_ ^= bit;
+      this->reversed_ ^= bit;
+    }
+    for (uint16_t part = 0; part < 2; part++) {
+      uint16_t i = 2 * m + part;
+      // Hann window; cos(2πi/N) for i > N/2 mirrors the first half of the table
+      float c = i < half ? this->twiddle_cos_[i] : (i == half ? -1.0f : this->twiddle_cos_[n - i]);
+      float w = 0.5f - 0.5f * c;
+      this->work_[2 * this->reversed_ + part] = (this->pending_[i] - this->pending_mean_) * this->digit_scale_ * w;
+    }
+  }
+  return true;
+}
+
+bool SpectrumAnalyzer::run_butterflies_(uint32_t start_us) {
+  uint16_t half = this->block_size_ / 2;
+  float *data = this->work_.data();
+
+  for (; this->span_ < half; this->span_ <<= 1, this->group_ = 0) {
+    // Twiddle for this stage is e^(-2πi·pair / (2·span)) = table[pair · N / (2·span)]
+    uint16_t stride = this->block_size_ / (2 * this->span_);
+    for (; this->group_ < half; this->group_ += 2 * this->span_, this->pair_ = 0) {
+      for (; this->pair_ < this->span_; this->pair_++) {
+        if (this->out_of_time_(start_us))
+          return false;
+        uint16_t a = 2 * (this->group_ + this->pair_);
+        uint16_t b = a + 2 * this->span_;
+        float wr = this->twiddle_cos_[this->pair_ * stride];
+        float wi = -this->twiddle_sin_[this->pair_ * stride];
+        float tr = wr * data[b] - wi * data[b + 1];
+        float ti = wr * data[b + 1] + wi * data[b];
+        data[b] = data[a] - tr;
+        data[b + 1] = data[a + 1] - ti;
+        data[a] += tr;
+        data[a + 1] += ti;
+      }
+    }
+  }
+  return true;
+}
+
+bool SpectrumAnalyzer::run_spectrum_(uint32_t start_us) {
+  uint16_t n = this->block_size_;
+  uint16_t half = n / 2;
+  const float *z = this->work_.data();
+  float bin_width = this->sample_rate_ / n;
+  // One-sided mean-square per bin: |X|² · 2 / (N² · mean(w²)); DC and Nyquist count once
+  float norm = 1.0f / (static_cast<float>(n) * n * this->window_power_);
+
+  for (; this->cursor_ <= half; this->cursor_++) {
+    if (this->out_of_time_(start_us))
+      return false;
+    uint16_t k = this->cursor_;
+    // Split the half-size complex spectrum Z into the real spectrum X:
+    //   X[k] = (Z[k] + Z*[M-k]) / 2 + e^(-2πik/N) · (Z[k] - Z*[M-k]) / 2i
+    uint16_t k1 = k % half;
+    uint16_t k2 = (half - k) % half;
+    float zr = z[2 * k1], zi = z[2 * k1 + 1];
+    float cr = z[2 * k2], ci = -z[2 * k2 + 1];
+    float er = 0.5f * (zr + cr), ei = 0.5f * (zi + ci);
+    float or_ = 0.5f * (zi - ci), oi = -0.5f * (zr - cr);
+    float c = k < half ? this->twiddle_cos_[k] : -1.0f;
+    float s = k < half ? this->twiddle_sin_[k] : 0.0f;
+    float xr = er + c * or_ + s * oi;
+    float xi = ei + c * oi - s * or_;
+    float power = xr * xr + xi * xi;
+
+    float mean_square = power * norm * ((k == 0 || k == half) ? 1.0f : 2.0f);
+    float frequency = k * bin_width;
+    for (auto &band : this->bands_) {
+      if (frequency >= band.min_frequency && frequency <= band.max_frequency)
+        band.sum += mean_square;
+    }
+
+    if (this->best_bin_ != 0 && k == this->best_bin_ + 1)
+      this->after_best_ = power;
+    if (k > 0 && k < half && power > this->best_power_) {
+      this->best_power_ = power;
+      this->best_bin_ = k;
+      this->before_best_ = this->previous_power_;
+    }
+    this->previous_power_ = power;
+  }
+  return true;
+}
+
+void SpectrumAnalyzer::finish_spectrum_() {
+  for (auto &band : this->bands_)
+    band.rms = sqrtf(band.sum);
+
+  // Parabolic interpolation between the neighbouring bins for sub-bin resolution
+  float offset = 0.0f;
+  float denominator = this->before_best_ - 2.0f * this->best_power_ + this->after_best_;
+  if (this->best_bin_ != 0 && denominator != 0.0f)
+    offset = 0.5f * (this->before_best_ - this->after_best_) / denominator;
+  this->dominant_frequency_ = (this->best_bin_ + offset) * (this->sample_rate_ / this->block_size_);
+  this->has_result_ = true;
+}
+
+void SpectrumAnalyzer::loop() {
+  if (this->stage_ == Stage::IDLE)
+    return;
+
+  uint32_t start_us = micros();
+  this->budget_check_ = 0;
+  // Every stage resumes where the previous pass ran out of budget
+  switch (this->stage_) {
+    case Stage::WINDOW:
+      if (!this->run_window_(start_us))
+        return;
+      this->span_ = 1;
+      this->group_ = 0;
+      this->pair_ = 0;
+      this->stage_ = Stage::BUTTERFLIES;
+      [[fallthrough]];
+    case Stage::BUTTERFLIES:
+      if (!this->run_butterflies_(start_us))
+        return;
+      this->cursor_ = 0;
+      this->best_power_ = this->before_best_ = this->after_best_ = this->previous_power_ = 0.0f;
+      this->best_bin_ = 0;
+      for (auto &band : this->bands_)
+        band.sum = 0.0f;
+      this->stage_ = Stage::SPECTRUM;
+      [[fallthrough]];
+    case Stage::SPECTRUM:
+      if (!this->run_spectrum_(start_us))
+        return;
+      break;
+    default:
+      return;
+  }
+
+  this->finish_spectrum_();
+  this->stage_ = Stage::IDLE;
+  ESP_LOGV(TAG, "Block analysed, dominant frequency %.2f Hz", this->dominant_frequency_);
+}
+
+void SpectrumAnalyzer::publish() {
+  if (!this->has_result_)
+    return;
+  if (this->dominant_frequency_sensor_ != nullptr)
+    this->dominant_frequency_sensor_->publish_state(this->dominant_frequency_);
+  for (auto &band : this->bands_) {
+    if (band.sensor != nullptr)
+      band.sensor->publish_state(band.rms);
+  }
+}
+
+}  // namespace lis3dh
+}  // namespace esphome
+
+#endif  // USE_LIS3DH_SPECTRUM
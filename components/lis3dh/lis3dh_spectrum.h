@@ -0,0 +1,139 @@
+#pragma once
+
+#include "esphome/core/defines.h"
+
+#ifdef USE_LIS3DH_SPECTRUM
+
+#include "esphome/components/sensor/sensor.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace esphome {
+namespace lis3dh {
+
+/// Frequency band whose RMS acceleration is published after each analysed block
+struct SpectrumBand {
+  float min_frequency;
+  float max_frequency;
+  sensor::Sensor *sensor;
+  float rms{0.0f};
+  /// Mean-square accumulated while the spectrum stage is running
+  float sum{0.0f};
+};
+
+/// Vibration spectrum of one channel: collects a power-of-two block of samples, then runs a
+/// Hann-windowed real FFT (as a half-size complex FFT with a precomputed twiddle table).
+/// Windowing, transform and spectrum are all split across loop() passes so no pass exceeds the
+/// configured time budget. While a block is being analysed the next one is already being collected.
+class SpectrumAnalyzer {
+ public:
+  void set_block_size(uint16_t block_size) { this->block_size_ = block_size; }
+  void set_time_budget(uint32_t time_budget_us) { this->time_budget_us_ = time_budget_us; }
+  void set_dominant_frequency_sensor(sensor::Sensor *sensor) { this->dominant_frequency_sensor_ = sensor; }
+  void add_band(float min_frequency, float max_frequency, sensor::Sensor *sensor) {
+    this->bands_.push_back(SpectrumBand{min_frequency, max_frequency, sensor});
+  }
+
+  /// Allocates all buffers and the twiddle table; nothing is allocated afterwards
+  void setup(float sample_rate, float digit_scale);
+  void dump_config();
+
+  /// Queue one raw sample (digits); O(1)
+  void add_sample(int16_t value) {
+    this->collect_sum_ += value;
+    this->collect_[this->collected_++] = value;
+    if (this->collected_ == this->block_size_) {
+      this->on_block_collected_();
+    }
+  }
+
+  /// Queue `count` raw samples, copied in runs up to each block boundary
+  void add_samples(const int16_t *values, size_t count) {
+    while (count > 0) {
+      size_t run = std::min<size_t>(count, this->block_size_ - this->collected_);
+      for (size_t i = 0; i < run; i++)
+        this->collect_sum_ += values[i];
+      std::copy(values, values + run, &this->collect_[this->collected_]);
+      this->collected_ += run;
+      values += run;
+      count -= run;
+      if (this->collected_ == this->block_size_) {
+        this->on_block_collected_();
+      }
+    }
+  }
+
+  /// Advance the pending analysis for at most the configured time budget
+  void loop();
+
+  /// Publish the results of the most recent block, if there is one
+  void publish();
+
+  uint32_t get_dropped_blocks() const { return this->dropped_blocks_; }
+
+ protected:
+  enum class Stage : uint8_t {
+    IDLE,
+    WINDOW,
+    BUTTERFLIES,
+    SPECTRUM,
+  };
+
+  void on_block_collected_();
+  /// Each stage returns false when the time budget ran out before it finished
+  bool run_window_(uint32_t start_us);
+  bool run_butterflies_(uint32_t start_us);
+  bool run_spectrum_(uint32_t start_us);
+  void finish_spectrum_();
+  bool out_of_time_(uint32_t start_us);
+
+  uint16_t block_size_{256};
+  uint32_t time_budget_us_{1000};
+  float sample_rate_{0.0f};
+  float digit_scale_{0.0f};
+
+  sensor::Sensor *dominant_frequency_sensor_{nullptr};
+  std::vector<SpectrumBand> bands_;
+
+  /// Samples of the block currently being collected
+  std::vector<int16_t> collect_;
+  uint16_t collected_{0};
+  int32_t collect_sum_{0};
+  /// The block being analysed, swapped out of collect_ when it filled up
+  std::vector<int16_t> pending_;
+  float pending_mean_{0.0f};
+  /// In-place workspace: block_size real samples, viewed as block_size / 2 interleaved complex values
+  std::vector<float> work_;
+  /// cos/sin of 2πk/N for k < N/2; the half-size FFT uses every other entry
+  std::vector<float> twiddle_cos_;
+  std::vector<float> twiddle_sin_;
+
+  Stage stage_{Stage::IDLE};
+  float window_power_{0.0f};
+  uint16_t budget_check_{0};
+  /// WINDOW: complex index and its bit reversal; SPECTRUM: bin
+  uint16_t cursor_{0};
+  uint16_t reversed_{0};
+  /// BUTTERFLIES position
+  uint16_t span_{0};
+  uint16_t group_{0};
+  uint16_t pair_{0};
+  /// SPECTRUM peak search
+  float best_power_{0.0f};
+  float before_best_{0.0f};
+  float after_best_{0.0f};
+  float previous_power_{0.0f};
+  uint16_t best_bin_{0};
+
+  float dominant_frequency_{0.0f};
+  bool has_result_{false};
+  uint32_t dropped_blocks_{0};
+};
+
+}  // namespace lis3dh
+}  // namespace esphome
+
+#endif  // USE_LIS3DH_SPECTRUM
@@ -0,0 +1,47 @@
+#include "lis3dh_spi.h"
+
+#ifdef USE_SPI
+
+#include "esphome/core/log.h"
+
+namespace esphome {
+namespace lis3dh {
+
+static const char *const TAG = "lis3dh.spi";
+
+void LIS3DHSPIComponent::setup() {
+  this->spi_setup();
+  LIS3DHComponent::setup();
+}
+
+void LIS3DHSPIComponent::dump_config() {
+  LIS3DHComponent::dump_config();
+  LOG_SPI_DEVICE(this);
+}
+
+bool LIS3DHSPIComponent::bus_read_(RegisterMap reg, uint8_t *data, size_t len) {
+  uint8_t address = static_cast<uint8_t>(reg) | SPI_READ;
+  if (len > 1)
+    address |= SPI_AUTO_INCREMENT;
+  this->enable();
+  this->write_byte(address);
+  this->read_array(data, len);
+  this->disable();
+  return true;
+}
+
+bool LIS3DHSPIComponent::bus_write_(RegisterMap reg, const uint8_t *data, size_t len) {
+  uint8_t address = static_cast<uint8_t>(reg);
+  if (len > 1)
+    address |= SPI_AUTO_INCREMENT;
+  this->enable();
+  this->write_byte(address);
+  this->write_array(data, len);
+  this->disable();
+  return true;
+}
+
+}  // namespace lis3dh
+}  // namespace esphome
+
+#endif  // USE_SPI
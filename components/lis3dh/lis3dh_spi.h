@@ -0,0 +1,34 @@
+#pragma once
+
+#include "esphome/core/defines.h"
+
+#ifdef USE_SPI
+
+#include "esphome/components/spi/spi.h"
+#include "lis3dh.h"
+
+namespace esphome {
+namespace lis3dh {
+
+/// First byte of every SPI transaction: bit 7 selects a read, bit 6 auto-increments the address
+static const uint8_t SPI_READ = 0x80;
+static const uint8_t SPI_AUTO_INCREMENT = 0x40;
+
+/// 4-wire SPI, mode 3 (CPOL = 1, CPHA = 1), up to 10 MHz
+class LIS3DHSPIComponent : public LIS3DHComponent,
+                           public spi::SPIDevice<spi::BIT_ORDER_MSB_FIRST, spi::CLOCK_POLARITY_HIGH,
+                                                 spi::CLOCK_PHASE_TRAILING, spi::DATA_RATE_8MHZ> {
+ public:
+  void setup() override;
+  void dump_config() override;
+
+ protected:
+  bool bus_read_(RegisterMap reg, uint8_t *data, size_t len) override;
+  bool bus_write_(RegisterMap reg, const uint8_t *data, size_t len) override;
+  const void *get_bus_() const override { return this->parent_; }
+};
+
+}  // namespace lis3dh
+}  // namespace esphome
+
+#endif  // USE_SPI
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace esphome {
+namespace lis3dh {
+
+enum class StatsKind : uint8_t {
+  MEAN = 0,
+  MIN = 1,
+  MAX = 2,
+  RMS = 3,
+  PEAK_TO_PEAK = 4,
+};
+
+static const uint8_t STATS_KIND_COUNT = 5;
+
+/// Running min/max/mean/RMS of one channel over an update interval, in raw digits.
+/// Constant memory and integer-only per sample; the float math happens once in get().
+class WindowStats {
+ public:
+  void add(int32_t value) {
+    this->count_++;
+    this->sum_ += value;
+    this->sum_squares_ += static_cast<int64_t>(value) * value;
+    if (value < this->min_)
+      this->min_ = value;
+    if (value > this->max_)
+      this->max_ = value;
+  }
+
+  /// Same as add() for each of `count` samples, with the accumulators held in locals so the
+  /// loop body is branch-free min/max and multiply-accumulate
+  void add_block(const int16_t *samples, size_t count) {
+    int64_t sum = 0;
+    int64_t sum_squares = 0;
+    int32_t min = this->min_;
+    int32_t max = this->max_;
+    for (size_t i = 0; i < count; i++) {
+      int32_t value = samples[i];
+      sum += value;
+      sum_squares += value * value;
+      min = std::min(min, value);
+      max = std::max(max, value);
+    }
+    this->count_ += count;
+    this->sum_ += sum;
+    this->sum_squares_ += sum_squares;
+    this->min_ = min;
+    this->max_ = max;
+  }
+
+  void reset() { *this = WindowStats{}; }
+
+  uint32_t count() const { return this->count_; }
+
+  /// Value of `kind` in digits; only meaningful when count() > 0
+  float get(StatsKind kind) const {
+    switch (kind) {
+      case StatsKind::MEAN:
+        return static_cast<float>(this->sum_) / this->count_;
+      case StatsKind::MIN:
+        return this->min_;
+      case StatsKind::MAX:
+        return this->max_;
+      case StatsKind::RMS:
+        return sqrtf(static_cast<float>(this->sum_squares_) / this->count_);
+      case StatsKind::PEAK_TO_PEAK:
+        return this->max_ - this->min_;
+      default:
+        return NAN;
+    }
+  }
+
+ protected:
+  uint32_t count_{0};
+  int64_t sum_{0};
+  int64_t sum_squares_{0};
+  int32_t min_{std::numeric_limits<int32_t>::max()};
+  int32_t max_{std::numeric_limits<int32_t>::min()};
+};
+
+}  // namespace lis3dh
+}  // namespace esphome
@@ -1,41 +1,321 @@
 import esphome.codegen as cg
 from esphome.components import sensor
 import esphome.config_validation as cv
+import esphome.final_validate as fv
 from esphome.const import (
     CONF_ACCELERATION_X,
     CONF_ACCELERATION_Y,
     CONF_ACCELERATION_Z,
+    CONF_CHANNEL,
+    CONF_MAX,
+    CONF_MIN,
     CONF_NAME,
+    DEVICE_CLASS_FREQUENCY,
     ICON_BRIEFCASE_DOWNLOAD,
+    ICON_GAUGE,
+    ENTITY_CATEGORY_DIAGNOSTIC,
+    ICON_SINE_WAVE,
     STATE_CLASS_MEASUREMENT,
+    STATE_CLASS_TOTAL_INCREASING,
+    UNIT_DEGREES,
+    UNIT_HERTZ,
     UNIT_METER_PER_SECOND_SQUARED,
+    UNIT_PERCENT,
 )
 
-from . import CONF_LIS3DH_ID, LIS3DH_SENSOR_SCHEMA
+from . import (
+    CONF_HIGH_PASS_FILTER,
+    CONF_LIS3DH_ID,
+    CONF_OUTPUT,
+    CONF_MAGNITUDE,
+    LIS3DH_SENSOR_SCHEMA,
+    SAMPLE_CHANNELS,
+    lis3dh_ns,
+    validate_pedometer_hub,
+)
 
 CODEOWNERS = ["@tjhorner"]
 DEPENDENCIES = ["lis3dh"]
 
+ICON_ANGLE_ACUTE = "mdi:angle-acute"
+ICON_COUNTER = "mdi:counter"
+ICON_WALK = "mdi:walk"
+UNIT_STEPS = "steps"
+
+CONF_BUS_UTILIZATION = "bus_utilization"
+CONF_SAMPLES_READ = "samples_read"
+CONF_SAMPLES_LOST = "samples_lost"
+CONF_BUS_ERRORS = "bus_errors"
+CONF_EVENTS_DROPPED = "events_dropped"
+CONF_MOTION_MAGNITUDE = "motion_magnitude"
+CONF_PITCH = "pitch"
+CONF_ROLL = "roll"
+CONF_TILT = "tilt"
+CONF_ANGLE_THRESHOLD = "angle_threshold"
+CONF_DEADBAND = "deadband"
+CONF_AXIS_THRESHOLD = "axis_threshold"
+CONF_VECTOR_THRESHOLD = "vector_threshold"
+CONF_MAX_SILENCE = "max_silence"
+CONF_STATISTICS = "statistics"
+CONF_MEAN = "mean"
+CONF_PEAK_TO_PEAK = "peak_to_peak"
+CONF_RMS = "rms"
+CONF_SPECTRUM = "spectrum"
+CONF_BLOCK_SIZE = "block_size"
+CONF_TIME_BUDGET = "time_budget"
+CONF_DOMINANT_FREQUENCY = "dominant_frequency"
+CONF_BANDS = "bands"
+CONF_MIN_FREQUENCY = "min_frequency"
+CONF_MAX_FREQUENCY = "max_frequency"
+CONF_STEP_COUNT = "step_count"
+
 ACCELERATION_SENSORS = (CONF_ACCELERATION_X, CONF_ACCELERATION_Y, CONF_ACCELERATION_Z)
+INCLINOMETER_SENSORS = (CONF_PITCH, CONF_ROLL, CONF_TILT)
+# Running totals since boot, published every update interval
+COUNTER_SENSORS = (
+    CONF_SAMPLES_READ,
+    CONF_SAMPLES_LOST,
+    CONF_BUS_ERRORS,
+    CONF_EVENTS_DROPPED,
+)
+
+StatsKind = lis3dh_ns.enum("StatsKind", True)
+STATS_KINDS = {
+    CONF_MEAN: StatsKind.MEAN,
+    CONF_MIN: StatsKind.MIN,
+    CONF_MAX: StatsKind.MAX,
+    CONF_RMS: StatsKind.RMS,
+    CONF_PEAK_TO_PEAK: StatsKind.PEAK_TO_PEAK,
+}
 
-accel_schema = cv.maybe_simple_value(
+accel_sensor_schema = sensor.sensor_schema(
+    unit_of_measurement=UNIT_METER_PER_SECOND_SQUARED,
+    icon=ICON_BRIEFCASE_DOWNLOAD,
+    accuracy_decimals=2,
+    state_class=STATE_CLASS_MEASUREMENT,
+)
+
+accel_schema = cv.maybe_simple_value(accel_sensor_schema, key=CONF_NAME)
+
+angle_schema = cv.maybe_simple_value(
     sensor.sensor_schema(
-        unit_of_measurement=UNIT_METER_PER_SECOND_SQUARED,
-        icon=ICON_BRIEFCASE_DOWNLOAD,
-        accuracy_decimals=2,
+        unit_of_measurement=UNIT_DEGREES,
+        icon=ICON_ANGLE_ACUTE,
+        accuracy_decimals=1,
         state_class=STATE_CLASS_MEASUREMENT,
     ),
     key=CONF_NAME,
 )
 
+counter_schema = sensor.sensor_schema(
+    icon=ICON_COUNTER,
+    accuracy_decimals=0,
+    state_class=STATE_CLASS_TOTAL_INCREASING,
+    entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+)
+
+stats_channel_schema = cv.Schema(
+    {cv.Optional(kind): accel_schema for kind in STATS_KINDS}
+)
+
+
+# Acceleration sensors publish only when the value moves (m/s²) or the heartbeat expires.
+# Without thresholds any change counts as a move, so a heartbeat alone only drops repeats.
+deadband_schema = cv.Schema(
+    {
+        cv.Optional(CONF_AXIS_THRESHOLD, default=0.0): cv.positive_float,
+        cv.Optional(CONF_VECTOR_THRESHOLD, default=0.0): cv.positive_float,
+        # Degrees, for pitch/roll/tilt
+        cv.Optional(CONF_ANGLE_THRESHOLD): cv.positive_float,
+        cv.Optional(
+            CONF_MAX_SILENCE, default="5min"
+        ): cv.positive_time_period_milliseconds,
+    }
+)
+
+
+def _validate_band(config):
+    if config[CONF_MIN_FREQUENCY] >= config[CONF_MAX_FREQUENCY]:
+        raise cv.Invalid(f"{CONF_MIN_FREQUENCY} must be below {CONF_MAX_FREQUENCY}")
+    return config
+
+
+# RMS acceleration of the spectrum between two frequencies
+band_schema = cv.All(
+    accel_sensor_schema.extend(
+        {
+            cv.Required(CONF_MIN_FREQUENCY): cv.frequency,
+            cv.Required(CONF_MAX_FREQUENCY): cv.frequency,
+        }
+    ),
+    _validate_band,
+)
+
+spectrum_schema = cv.Schema(
+    {
+        cv.Optional(CONF_BLOCK_SIZE, default=256): cv.one_of(
+            64, 128, 256, 512, 1024, int=True
+        ),
+        cv.Optional(CONF_CHANNEL, default=CONF_MAGNITUDE): cv.enum(
+            SAMPLE_CHANNELS, lower=True
+        ),
+        cv.Optional(
+            CONF_TIME_BUDGET, default="1ms"
+        ): cv.positive_time_period_microseconds,
+        cv.Optional(CONF_DOMINANT_FREQUENCY): sensor.sensor_schema(
+            unit_of_measurement=UNIT_HERTZ,
+            icon=ICON_SINE_WAVE,
+            accuracy_decimals=1,
+            device_class=DEVICE_CLASS_FREQUENCY,
+            state_class=STATE_CLASS_MEASUREMENT,
+        ),
+        cv.Optional(CONF_BANDS): cv.ensure_list(band_schema),
+    }
+)
+
 CONFIG_SCHEMA = LIS3DH_SENSOR_SCHEMA.extend(
     {cv.Optional(sensor_key): accel_schema for sensor_key in ACCELERATION_SENSORS}
+).extend(
+    {
+        # Inclinometer angles of the filtered acceleration, in degrees
+        cv.Optional(CONF_PITCH): angle_schema,
+        cv.Optional(CONF_ROLL): angle_schema,
+        cv.Optional(CONF_TILT): angle_schema,
+        # LIS3DH share of bus time: the part spent in LIS3DH transactions. Other devices
+        # on the bus aren't seen, so this is a lower bound on the bus's actual load.
+        cv.Optional(CONF_BUS_UTILIZATION): sensor.sensor_schema(
+            unit_of_measurement=UNIT_PERCENT,
+            icon=ICON_GAUGE,
+            accuracy_decimals=1,
+            state_class=STATE_CLASS_MEASUREMENT,
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+        ),
+        cv.Optional(CONF_SAMPLES_READ): counter_schema,
+        # Overwritten on the chip before they were read, or dropped on the way to loop()
+        cv.Optional(CONF_SAMPLES_LOST): counter_schema,
+        cv.Optional(CONF_BUS_ERRORS): counter_schema,
+        # Events that arrived while the queue to the automations was full
+        cv.Optional(CONF_EVENTS_DROPPED): counter_schema,
+        # RMS of the gravity-free acceleration vector over each update interval
+        cv.Optional(CONF_MOTION_MAGNITUDE): accel_sensor_schema,
+        cv.Optional(CONF_DEADBAND): deadband_schema,
+        cv.Optional(CONF_STATISTICS): cv.Schema(
+            {cv.Optional(channel): stats_channel_schema for channel in SAMPLE_CHANNELS}
+        ),
+        cv.Optional(CONF_SPECTRUM): spectrum_schema,
+        # Steps since boot, from the magnitude of every sample
+        cv.Optional(CONF_STEP_COUNT): sensor.sensor_schema(
+            unit_of_measurement=UNIT_STEPS,
+            icon=ICON_WALK,
+            accuracy_decimals=0,
+            state_class=STATE_CLASS_TOTAL_INCREASING,
+        ),
+    }
 )
 
 
+def _final_validate(config):
+    full_config = fv.full_config.get()
+    hub_path = full_config.get_path_for_id(config[CONF_LIS3DH_ID])[:-1]
+    high_pass = full_config.get_config_for_path(hub_path).get(CONF_HIGH_PASS_FILTER)
+    gravity_removed = high_pass is not None and high_pass[CONF_OUTPUT]
+    if CONF_MOTION_MAGNITUDE in config and not gravity_removed:
+        raise cv.Invalid(
+            f"{CONF_MOTION_MAGNITUDE} needs the {CONF_HIGH_PASS_FILTER} on the {CONF_OUTPUT}",
+            path=[CONF_MOTION_MAGNITUDE],
+        )
+    for sensor_key in INCLINOMETER_SENSORS:
+        if sensor_key in config and gravity_removed:
+            # The angles are taken against gravity, which the filter removes
+            raise cv.Invalid(
+                f"{sensor_key} can't be used with the {CONF_HIGH_PASS_FILTER} on the {CONF_OUTPUT}",
+                path=[sensor_key],
+            )
+    if CONF_STEP_COUNT in config:
+        validate_pedometer_hub(config, CONF_STEP_COUNT)
+    return config
+
+
+FINAL_VALIDATE_SCHEMA = _final_validate
+
+
 async def to_code(config):
     hub = await cg.get_variable(config[CONF_LIS3DH_ID])
     for accel_key in ACCELERATION_SENSORS:
         if accel_key in config:
             sens = await sensor.new_sensor(config[accel_key])
             cg.add(getattr(hub, f"set_{accel_key}_sensor")(sens))
+
+    if any(sensor_key in config for sensor_key in INCLINOMETER_SENSORS):
+        cg.add_define("USE_LIS3DH_INCLINOMETER")
+        for sensor_key in INCLINOMETER_SENSORS:
+            if sensor_key in config:
+                sens = await sensor.new_sensor(config[sensor_key])
+                cg.add(getattr(hub, f"set_{sensor_key}_sensor")(sens))
+        deadband = config.get(CONF_DEADBAND, {})
+        cg.add(
+            hub.set_inclinometer_deadband(
+                deadband.get(CONF_ANGLE_THRESHOLD, 0.0),
+                deadband[CONF_MAX_SILENCE].total_milliseconds if deadband else 0,
+            )
+        )
+
+    if CONF_BUS_UTILIZATION in config:
+        sens = await sensor.new_sensor(config[CONF_BUS_UTILIZATION])
+        cg.add(hub.set_bus_utilization_sensor(sens))
+    for counter_key in COUNTER_SENSORS:
+        if counter_key in config:
+            sens = await sensor.new_sensor(config[counter_key])
+            cg.add(getattr(hub, f"set_{counter_key}_sensor")(sens))
+
+    if CONF_MOTION_MAGNITUDE in config:
+        cg.add_define("USE_LIS3DH_MOTION_MAGNITUDE")
+        sens = await sensor.new_sensor(config[CONF_MOTION_MAGNITUDE])
+        cg.add(hub.set_motion_magnitude_sensor(sens))
+
+    deadband = config.get(CONF_DEADBAND)
+    if deadband is not None:
+        cg.add_define("USE_LIS3DH_DEADBAND")
+        cg.add(
+            hub.set_deadband(
+                deadband[CONF_AXIS_THRESHOLD],
+                deadband[CONF_VECTOR_THRESHOLD],
+                deadband[CONF_MAX_SILENCE].total_milliseconds,
+            )
+        )
+
+    if CONF_STATISTICS in config:
+        cg.add_define("USE_LIS3DH_STATISTICS")
+        for channel, channel_config in config[CONF_STATISTICS].items():
+            for kind, sensor_config in channel_config.items():
+                sens = await sensor.new_sensor(sensor_config)
+                cg.add(
+                    hub.set_statistics_sensor(
+                        SAMPLE_CHANNELS[channel], STATS_KINDS[kind], sens
+                    )
+                )
+
+    if CONF_SPECTRUM in config:
+        spectrum = config[CONF_SPECTRUM]
+        cg.add_define("USE_LIS3DH_SPECTRUM")
+        cg.add(hub.set_spectrum_block_size(spectrum[CONF_BLOCK_SIZE]))
+        cg.add(hub.set_spectrum_channel(spectrum[CONF_CHANNEL]))
+        cg.add(
+            hub.set_spectrum_time_budget(spectrum[CONF_TIME_BUDGET].total_microseconds)
+        )
+        if CONF_DOMINANT_FREQUENCY in spectrum:
+            sens = await sensor.new_sensor(spectrum[CONF_DOMINANT_FREQUENCY])
+            cg.add(hub.set_dominant_frequency_sensor(sens))
+        for band in spectrum.get(CONF_BANDS, []):
+            sens = await sensor.new_sensor(band)
+            cg.add(
+                hub.add_spectrum_band(
+                    band[CONF_MIN_FREQUENCY], band[CONF_MAX_FREQUENCY], sens
+                )
+            )
+
+    if CONF_STEP_COUNT in config:
+        cg.add_define("USE_LIS3DH_PEDOMETER")
+        cg.add(hub.enable_pedometer())
+        sens = await sensor.new_sensor(config[CONF_STEP_COUNT])
+        cg.add(hub.set_step_count_sensor(sens))
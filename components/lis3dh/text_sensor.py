@@ -2,27 +2,50 @@ import esphome.codegen as cg
 from esphome.components import text_sensor
 import esphome.config_validation as cv
 
-from . import CONF_LIS3DH_ID, LIS3DH_SENSOR_SCHEMA
+from . import CONF_LIS3DH_ID, LIS3DH_SENSOR_SCHEMA, validate_pedometer_hub
 
 CODEOWNERS = ["@tjhorner"]
 DEPENDENCIES = ["lis3dh"]
 
+ICON_WALK = "mdi:walk"
+
 CONF_ORIENTATION_XY = "orientation_xy"
 CONF_ORIENTATION_Z = "orientation_z"
+CONF_ACTIVITY = "activity"
 
 CONFIG_SCHEMA = LIS3DH_SENSOR_SCHEMA.extend(
     {
         cv.Optional(CONF_ORIENTATION_XY): text_sensor.text_sensor_schema(),
         cv.Optional(CONF_ORIENTATION_Z): text_sensor.text_sensor_schema(),
+        # Still, Walking or Running, from the step detector's cadence and impact
+        cv.Optional(CONF_ACTIVITY): text_sensor.text_sensor_schema(icon=ICON_WALK),
     }
 )
 
 
+def _final_validate(config):
+    if CONF_ACTIVITY in config:
+        validate_pedometer_hub(config, CONF_ACTIVITY)
+    return config
+
+
+FINAL_VALIDATE_SCHEMA = _final_validate
+
+
 async def to_code(config):
     hub = await cg.get_variable(config[CONF_LIS3DH_ID])
+    if CONF_ORIENTATION_XY in config or CONF_ORIENTATION_Z in config:
+        # The orientation sensors follow the chip's 6D detector
+        cg.add_define("USE_LIS3DH_ORIENTATION_DETECTION")
+        cg.add(hub.enable_orientation_detection())
     if CONF_ORIENTATION_XY in config:
         sens = await text_sensor.new_text_sensor(config[CONF_ORIENTATION_XY])
         cg.add(hub.set_orientation_xy_text_sensor(sens))
     if CONF_ORIENTATION_Z in config:
         sens = await text_sensor.new_text_sensor(config[CONF_ORIENTATION_Z])
         cg.add(hub.set_orientation_z_text_sensor(sens))
+    if CONF_ACTIVITY in config:
+        cg.add_define("USE_LIS3DH_PEDOMETER")
+        cg.add(hub.enable_pedometer())
+        sens = await text_sensor.new_text_sensor(config[CONF_ACTIVITY])
+        cg.add(hub.set_activity_text_sensor(sens))